@@ -74,7 +74,7 @@ def build_and_bench(version):
         pass
     call(['cmake', '..', '-DBENCHMARK_EIGEN=ON'])
     call(['make', 'xpowerbench'])
-    os.rename(absdir + '/build/bench.csv', absdir + f'/stats/{version}.csv')
+    os.rename(absdir + '/build/bench.json', absdir + f'/stats/{version}.json')
 
 def run():
     init()
@@ -0,0 +1,344 @@
+"""Cross-library comparison report for xtensor_benchmark results.
+
+Reads the JSON written by ``xtensor_benchmark --benchmark_out=bench.json
+--benchmark_out_format=json`` (``make xbenchmark`` does this), groups the
+runs by kernel family and size across the library suffixes, and prints
+ratio tables plus the list of sizes where xtensor is more than a given
+factor slower than the fastest library. Builds with BENCHMARK_MULTI_ISA
+name their benchmarks <name>@<isa>; libraries are then compared within
+each instruction set, and every instruction set is compared to scalar.
+With --cold, the results of a BENCHMARK_COLD_CACHE build are reported next
+to the warm ones.
+
+    python report.py build/bench.json --factor 1.5 --plots plots/
+    python report.py warm/bench.json --cold cold/bench.json
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+from collections import OrderedDict
+
+LIBRARIES = ['XTensor', 'Eigen', 'Blitz', 'Arma', 'Pythonic']
+REFERENCE = 'XTensor'
+
+TIME_UNITS = {'ns': 1.0, 'us': 1e3, 'ms': 1e6, 's': 1e9}
+
+BASELINE_ISA = 'scalar'
+
+NAME_RE = re.compile(r'^(?P<family>.+?)_(?P<library>' + '|'.join(LIBRARIES) + r')'
+                     r'(?P<template><.*>)?(?:@(?P<isa>\w+))?$')
+
+
+def parse_name(name):
+    """Split 'Add2D_Eigen/64' into ('Add2D', 'Eigen', '64').
+
+    The instruction set of a multi-ISA build stays in the family:
+    'Add2D_Eigen@avx2/64' gives ('Add2D@avx2', 'Eigen', '64'). Returns
+    None for benchmarks that do not follow the <Family>_<Library> naming
+    convention.
+    """
+    head, _, size = name.partition('/')
+    match = NAME_RE.match(head)
+    if match is None:
+        return None
+    template = match.group('template') or ''
+    if template and size:
+        size = template + '/' + size
+    elif template:
+        size = template
+    family = match.group('family')
+    if match.group('isa'):
+        family += '@' + match.group('isa')
+    return family, match.group('library'), size
+
+
+def size_key(size):
+    numbers = [int(n) for n in re.findall(r'\d+', size)]
+    return (numbers, size)
+
+
+# Run options google benchmark appends to the name, e.g. /threads:4 in
+# throughput mode or /iterations:100/manual_time in cold-cache mode.
+OPTIONS_RE = re.compile(r'/(?:threads|iterations):\d+|/(?:real|manual)_time')
+THREADS_RE = re.compile(r'/threads:(\d+)')
+
+
+def load(path):
+    """Return (results, threaded).
+
+    results is {family: {size: {library: real time in ns}}} for the
+    single-threaded runs; threaded is {(family, size): {library: {threads:
+    real time in ns}}} for the kernels that also ran on several threads.
+    """
+    with open(path) as f:
+        data = json.load(f)
+
+    results = OrderedDict()
+    threaded = OrderedDict()
+    for bench in data.get('benchmarks', []):
+        if bench.get('error_occurred'):
+            continue
+        # With --benchmark_repetitions, only keep the mean.
+        if bench.get('run_type') == 'aggregate' and bench.get('aggregate_name') != 'mean':
+            continue
+        if bench.get('run_type') == 'iteration' and bench.get('repetitions', 1) > 1:
+            continue
+        name = bench.get('run_name', bench['name'])
+        parsed = parse_name(name)
+        if parsed is None:
+            continue
+        family, library, size = parsed
+        # Older google benchmark versions do not write the threads field.
+        threads_match = THREADS_RE.search(name)
+        threads = int(threads_match.group(1)) if threads_match else bench.get('threads', 1)
+        size = OPTIONS_RE.sub('', '/' + size)[1:]
+        time = bench['real_time'] * TIME_UNITS[bench.get('time_unit', 'ns')]
+        if threads == 1:
+            results.setdefault(family, OrderedDict()).setdefault(size, {})[library] = time
+        if threads_match:
+            threaded.setdefault((family, size), {}).setdefault(library, {})[threads] = time
+    return results, threaded
+
+
+def cache_mode(path):
+    """Return 'cold' for the output of a BENCHMARK_COLD_CACHE build, else 'warm'.
+
+    Cold-cache builds time every benchmark manually; google benchmark
+    versions with custom contexts also write cache=cold to the context.
+    """
+    with open(path) as f:
+        data = json.load(f)
+    if data.get('context', {}).get('cache') == 'cold':
+        return 'cold'
+    names = [bench['name'] for bench in data.get('benchmarks', [])]
+    if any('/manual_time' in name for name in names):
+        return 'cold'
+    return 'warm'
+
+
+def format_time(ns):
+    for unit, scale in (('s', 1e9), ('ms', 1e6), ('us', 1e3)):
+        if ns >= scale:
+            return '%.3g %s' % (ns / scale, unit)
+    return '%.3g ns' % ns
+
+
+def compare(results, factor):
+    """Return (tables, gaps).
+
+    tables maps a family to a list of rows (size, {library: (time, ratio)});
+    the ratio is relative to the fastest library for that size. gaps lists
+    (family, size, ratio, best library) where xtensor is slower than the
+    best library by more than `factor`.
+    """
+    tables = OrderedDict()
+    gaps = []
+    for family, sizes in results.items():
+        rows = []
+        for size in sorted(sizes, key=size_key):
+            times = sizes[size]
+            best_library = min(times, key=times.get)
+            best = times[best_library]
+            row = {lib: (t, t / best if best > 0 else float('nan')) for lib, t in times.items()}
+            rows.append((size, row))
+            if REFERENCE in row and len(row) > 1:
+                ratio = row[REFERENCE][1]
+                if ratio > factor:
+                    gaps.append((family, size, ratio, best_library))
+        tables[family] = rows
+    gaps.sort(key=lambda g: g[2], reverse=True)
+    return tables, gaps
+
+
+def print_tables(tables, factor, out):
+    for family, rows in tables.items():
+        libraries = [lib for lib in LIBRARIES if any(lib in row for _, row in rows)]
+        if len(libraries) < 2:
+            continue
+        out.write('\n### %s\n\n' % family)
+        out.write('| size | ' + ' | '.join(libraries) + ' |\n')
+        out.write('|---' * (len(libraries) + 1) + '|\n')
+        for size, row in rows:
+            cells = []
+            for lib in libraries:
+                if lib not in row:
+                    cells.append('-')
+                    continue
+                time, ratio = row[lib]
+                flag = ' **!**' if lib == REFERENCE and ratio > factor else ''
+                cells.append('%s (x%.2f)%s' % (format_time(time), ratio, flag))
+            out.write('| %s | %s |\n' % (size or '-', ' | '.join(cells)))
+
+
+def print_gaps(gaps, factor, out):
+    out.write('\n## xtensor more than x%.2f slower than the best library\n\n' % factor)
+    if not gaps:
+        out.write('None.\n')
+        return
+    out.write('| family | size | ratio | best |\n|---|---|---|---|\n')
+    for family, size, ratio, best in gaps:
+        out.write('| %s | %s | x%.2f | %s |\n' % (family, size or '-', ratio, best))
+
+
+def print_throughput(threaded, out):
+    """Print the aggregate throughput and per-thread slowdown per thread count.
+
+    With several threads, google benchmark reports the wall time divided by
+    the iterations of all the threads, i.e. the inverse of the aggregate
+    throughput; the time of one operation on one thread is N times that.
+    """
+    if not any(len(runs) > 1 for libraries in threaded.values() for runs in libraries.values()):
+        return
+    out.write('\n## Multi-threaded throughput\n\n')
+    out.write('Aggregate operations per second, and in parentheses the slowdown of each thread '
+              'compared with a single thread.\n\n')
+    out.write('| kernel | size | threads | ' + ' | '.join(LIBRARIES) + ' |\n')
+    out.write('|---' * (len(LIBRARIES) + 3) + '|\n')
+    for (family, size), libraries in sorted(threaded.items(), key=lambda k: (k[0][0], size_key(k[0][1]))):
+        counts = sorted(set(n for runs in libraries.values() for n in runs))
+        for n in counts:
+            cells = []
+            for lib in LIBRARIES:
+                runs = libraries.get(lib, {})
+                if n not in runs:
+                    cells.append('-')
+                    continue
+                ops = 1e9 / runs[n] if runs[n] > 0 else float('nan')
+                if 1 in runs and runs[1] > 0:
+                    cells.append('%.3g/s (x%.2f)' % (ops, runs[n] * n / runs[1]))
+                else:
+                    cells.append('%.3g/s' % ops)
+            out.write('| %s | %s | %d | %s |\n' % (family, size or '-', n, ' | '.join(cells)))
+
+
+def print_cold_cache(warm, cold, out):
+    """Print, per kernel and size, the warm and cold times and their ratio."""
+    out.write('\n## Cold cache\n\n')
+    out.write('Warm time / cold time, and in parentheses the slowdown of the cold run.\n\n')
+    out.write('| kernel | size | ' + ' | '.join(LIBRARIES) + ' |\n')
+    out.write('|---' * (len(LIBRARIES) + 2) + '|\n')
+    for family, sizes in cold.items():
+        for size in sorted(sizes, key=size_key):
+            cells = []
+            for lib in LIBRARIES:
+                cold_time = sizes[size].get(lib)
+                warm_time = warm.get(family, {}).get(size, {}).get(lib)
+                if cold_time is None:
+                    cells.append('-')
+                elif warm_time is None:
+                    cells.append('- / %s' % format_time(cold_time))
+                else:
+                    ratio = cold_time / warm_time if warm_time > 0 else float('nan')
+                    cells.append('%s / %s (x%.2f)' % (format_time(warm_time), format_time(cold_time), ratio))
+            out.write('| %s | %s | %s |\n' % (family, size or '-', ' | '.join(cells)))
+
+
+def print_isa_speedups(results, out):
+    """Print, per kernel, the speedup of every instruction set over scalar."""
+    speedups = OrderedDict()
+    isas = []
+    for family, sizes in results.items():
+        base, _, isa = family.partition('@')
+        if not isa:
+            continue
+        if isa not in isas:
+            isas.append(isa)
+        for size, times in sizes.items():
+            for library, time in times.items():
+                speedups.setdefault((base, library, size), {})[isa] = time
+    if not speedups:
+        return
+
+    isas = [BASELINE_ISA] + [isa for isa in isas if isa != BASELINE_ISA]
+    out.write('\n## Speedup over %s per instruction set\n\n' % BASELINE_ISA)
+    out.write('| kernel | size | ' + ' | '.join(isas) + ' |\n')
+    out.write('|---' * (len(isas) + 2) + '|\n')
+    for (base, library, size), times in sorted(speedups.items(), key=lambda k: (k[0][0], k[0][1], size_key(k[0][2]))):
+        reference = times.get(BASELINE_ISA)
+        cells = []
+        for isa in isas:
+            if isa not in times or not reference:
+                cells.append('-')
+            else:
+                cells.append('x%.2f' % (reference / times[isa]))
+        out.write('| %s_%s | %s | %s |\n' % (base, library, size or '-', ' | '.join(cells)))
+
+
+def plot(tables, directory):
+    """Write one log-log time vs. size plot per family with a numeric size."""
+    try:
+        from matplotlib import pyplot as plt
+    except ImportError:
+        sys.stderr.write('matplotlib is not available, skipping plots\n')
+        return
+
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+
+    for family, rows in tables.items():
+        series = {}
+        for size, row in rows:
+            numbers = re.findall(r'\d+', size)
+            if len(numbers) != 1:
+                continue
+            for lib, (time, _) in row.items():
+                series.setdefault(lib, []).append((int(numbers[0]), time))
+        if len(series) < 2:
+            continue
+        fig, ax = plt.subplots()
+        for lib in LIBRARIES:
+            if lib in series:
+                xs, ys = zip(*sorted(series[lib]))
+                ax.loglog(xs, ys, marker='o', label=lib)
+        ax.set_title(family)
+        ax.set_xlabel('size')
+        ax.set_ylabel('time (ns)')
+        ax.legend()
+        fig.savefig(os.path.join(directory, family + '.png'))
+        plt.close(fig)
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('json', help='google benchmark JSON output')
+    parser.add_argument('--factor', type=float, default=1.25,
+                        help='flag sizes where xtensor is slower than the best library by more than this factor')
+    parser.add_argument('--plots', metavar='DIR', help='write log-log scaling plots to DIR')
+    parser.add_argument('--cold', metavar='JSON', help='output of a BENCHMARK_COLD_CACHE build to compare with')
+    parser.add_argument('--output', metavar='FILE', help='write the report to FILE instead of stdout')
+    args = parser.parse_args(argv)
+
+    results, threaded = load(args.json)
+    if cache_mode(args.json) == 'cold':
+        sys.stderr.write('warning: %s comes from a cold-cache build\n' % args.json)
+    cold = None
+    if args.cold:
+        if cache_mode(args.cold) != 'cold':
+            sys.stderr.write('warning: %s does not come from a cold-cache build\n' % args.cold)
+        cold, _ = load(args.cold)
+    tables, gaps = compare(results, args.factor)
+
+    out = open(args.output, 'w') if args.output else sys.stdout
+    try:
+        out.write('# xtensor benchmark report\n\n')
+        out.write('Times are real time per iteration; (xN) is the ratio to the fastest library.\n')
+        print_gaps(gaps, args.factor, out)
+        out.write('\n## Ratio tables\n')
+        print_tables(tables, args.factor, out)
+        print_throughput(threaded, out)
+        print_isa_speedups(results, out)
+        if cold is not None:
+            print_cold_cache(results, cold, out)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+
+    if args.plots:
+        plot(tables, args.plots)
+
+
+if __name__ == '__main__':
+    main()
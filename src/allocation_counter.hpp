@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BENCHMARK_ALLOCATION_COUNTER_HPP
+#define XTENSOR_BENCHMARK_ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+// Heap allocation counting, enabled with -DBENCHMARK_COUNT_ALLOCATIONS=ON.
+// The C allocation functions are interposed (rather than operator new) so
+// that xsimd's aligned allocator, which calls malloc directly, is counted
+// too. This is only possible with glibc; elsewhere the count stays at 0.
+
+#if defined(COUNT_ALLOCATIONS) && defined(__GLIBC__)
+#define HAS_ALLOCATION_COUNTER 1
+
+inline std::atomic<std::size_t>& allocation_count()
+{
+    static std::atomic<std::size_t> count(0);
+    return count;
+}
+
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void* __libc_memalign(std::size_t, std::size_t);
+
+    void* malloc(std::size_t size) noexcept
+    {
+        allocation_count().fetch_add(1, std::memory_order_relaxed);
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t n, std::size_t size) noexcept
+    {
+        allocation_count().fetch_add(1, std::memory_order_relaxed);
+        return __libc_calloc(n, size);
+    }
+
+    void* realloc(void* ptr, std::size_t size) noexcept
+    {
+        allocation_count().fetch_add(1, std::memory_order_relaxed);
+        return __libc_realloc(ptr, size);
+    }
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+    {
+        allocation_count().fetch_add(1, std::memory_order_relaxed);
+        return __libc_memalign(alignment, size);
+    }
+
+    void* memalign(std::size_t alignment, std::size_t size) noexcept
+    {
+        allocation_count().fetch_add(1, std::memory_order_relaxed);
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** ptr, std::size_t alignment, std::size_t size) noexcept
+    {
+        allocation_count().fetch_add(1, std::memory_order_relaxed);
+        void* res = __libc_memalign(alignment, size);
+        if (res == nullptr)
+        {
+            return ENOMEM;
+        }
+        *ptr = res;
+        return 0;
+    }
+}
+#endif
+
+inline std::size_t current_allocation_count()
+{
+#ifdef HAS_ALLOCATION_COUNTER
+    return allocation_count().load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+// Sets the "allocs" counter to the number of heap allocations per iteration
+// since `start`, as returned by current_allocation_count().
+inline void report_allocations(benchmark::State& state, std::size_t start)
+{
+#ifdef HAS_ALLOCATION_COUNTER
+    std::size_t count = current_allocation_count() - start;
+    state.counters["allocs"] = static_cast<double>(count) / static_cast<double>(state.iterations());
+#else
+    (void)state;
+    (void)start;
+#endif
+}
+
+#endif
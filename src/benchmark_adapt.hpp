@@ -0,0 +1,403 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "cold_cache.hpp"
+
+#ifdef HAS_XTENSOR
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xio.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xadapt.hpp"
+#endif
+
+#ifdef HAS_EIGEN
+#include <Eigen/Dense>
+#include <Eigen/Core>
+#endif
+
+#ifdef HAS_ARMADILLO
+#include <armadillo>
+#endif
+
+#define RANGE 3, 1000
+#define MULTIPLIER 8
+
+// Every kernel below works on memory that is owned by someone else; the
+// Construct* kernels time the adaptor alone, the Add* kernels time compute
+// over adapted operands so that hidden copies or lost alignment show up.
+
+#ifdef HAS_XTENSOR
+void ConstructAdaptVector2D_XTensor(benchmark::State& state)
+{
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::array<std::size_t, 2> vShape = {n, n};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vAdapt = xt::adapt(vA, vShape);
+        benchmark::DoNotOptimize(vAdapt);
+    }
+}
+BENCHMARK(ConstructAdaptVector2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void ConstructAdaptPointer2D_XTensor(benchmark::State& state)
+{
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::array<std::size_t, 2> vShape = {n, n};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vAdapt = xt::adapt(vA.data(), vA.size(), xt::no_ownership(), vShape);
+        benchmark::DoNotOptimize(vAdapt);
+    }
+}
+BENCHMARK(ConstructAdaptPointer2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void ConstructAdaptPointerDynamic2D_XTensor(benchmark::State& state)
+{
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::vector<std::size_t> vShape = {n, n};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vAdapt = xt::adapt(vA.data(), vA.size(), xt::no_ownership(), vShape);
+        benchmark::DoNotOptimize(vAdapt);
+    }
+}
+BENCHMARK(ConstructAdaptPointerDynamic2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void ConstructAdaptAcquire2D_XTensor(benchmark::State& state)
+{
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::array<std::size_t, 2> vShape = {n, n};
+    std::allocator<double> vAlloc;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        double* vBuffer = vAlloc.allocate(n * n);
+        auto vAdapt = xt::adapt(vBuffer, n * n, xt::acquire_ownership(), vShape);
+        benchmark::DoNotOptimize(vAdapt);
+    }
+}
+BENCHMARK(ConstructAdaptAcquire2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void ConstructAdaptStrided2D_XTensor(benchmark::State& state)
+{
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(4 * n * n, 1.0);
+    std::array<std::size_t, 2> vShape = {n, n};
+    std::array<std::size_t, 2> vStrides = {4 * n, 2};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vAdapt = xt::adapt(vA.data(), vA.size(), xt::no_ownership(), vShape, vStrides);
+        benchmark::DoNotOptimize(vAdapt);
+    }
+}
+BENCHMARK(ConstructAdaptStrided2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dAdaptVector_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::vector<double> vB(n * n, 2.0);
+    std::vector<double> vRes(n * n);
+    std::array<std::size_t, 2> vShape = {n, n};
+
+    auto vAAdapt = adapt(vA, vShape);
+    auto vBAdapt = adapt(vB, vShape);
+    auto vResAdapt = adapt(vRes, vShape);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vResAdapt) = vAAdapt + vBAdapt;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dAdaptVector_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dAdaptPointer_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::vector<double> vB(n * n, 2.0);
+    std::vector<double> vRes(n * n);
+    std::array<std::size_t, 2> vShape = {n, n};
+
+    auto vAAdapt = adapt(vA.data(), vA.size(), no_ownership(), vShape);
+    auto vBAdapt = adapt(vB.data(), vB.size(), no_ownership(), vShape);
+    auto vResAdapt = adapt(vRes.data(), vRes.size(), no_ownership(), vShape);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vResAdapt) = vAAdapt + vBAdapt;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dAdaptPointer_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dAdaptPointerDynamic_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::vector<double> vB(n * n, 2.0);
+    std::vector<double> vRes(n * n);
+    std::vector<std::size_t> vShape = {n, n};
+
+    auto vAAdapt = adapt(vA.data(), vA.size(), no_ownership(), vShape);
+    auto vBAdapt = adapt(vB.data(), vB.size(), no_ownership(), vShape);
+    auto vResAdapt = adapt(vRes.data(), vRes.size(), no_ownership(), vShape);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vResAdapt) = vAAdapt + vBAdapt;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dAdaptPointerDynamic_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dAdaptStrided_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(4 * n * n, 1.0);
+    std::vector<double> vB(4 * n * n, 2.0);
+    std::array<std::size_t, 2> vShape = {n, n};
+    std::array<std::size_t, 2> vStrides = {4 * n, 2};
+
+    auto vAAdapt = adapt(vA.data(), vA.size(), no_ownership(), vShape, vStrides);
+    auto vBAdapt = adapt(vB.data(), vB.size(), no_ownership(), vShape, vStrides);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> vRes(vAAdapt + vBAdapt);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dAdaptStrided_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_EIGEN
+void ConstructMap2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        Map<MatrixXd> vMap(vA.data(), state.range(0), state.range(0));
+        benchmark::DoNotOptimize(vMap);
+    }
+}
+BENCHMARK(ConstructMap2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dMap_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::vector<double> vB(n * n, 2.0);
+    std::vector<double> vRes(n * n);
+
+    Map<MatrixXd> vAMap(vA.data(), state.range(0), state.range(0));
+    Map<MatrixXd> vBMap(vB.data(), state.range(0), state.range(0));
+    Map<MatrixXd> vResMap(vRes.data(), state.range(0), state.range(0));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vResMap.noalias() = vAMap + vBMap;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dMap_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dMapStrided_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    using strided_map = Map<Matrix<double, Dynamic, Dynamic, RowMajor>, 0, Stride<Dynamic, Dynamic>>;
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(4 * n * n, 1.0);
+    std::vector<double> vB(4 * n * n, 2.0);
+    Stride<Dynamic, Dynamic> vStride(4 * state.range(0), 2);
+
+    strided_map vAMap(vA.data(), state.range(0), state.range(0), vStride);
+    strided_map vBMap(vB.data(), state.range(0), state.range(0), vStride);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        Matrix<double, Dynamic, Dynamic, RowMajor> vRes(vAMap + vBMap);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dMapStrided_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_ARMADILLO
+void ConstructAux2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        mat vMat(vA.data(), n, n, false, true);
+        benchmark::DoNotOptimize(vMat.memptr());
+    }
+}
+BENCHMARK(ConstructAux2D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Add2dAux_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> vA(n * n, 1.0);
+    std::vector<double> vB(n * n, 2.0);
+    std::vector<double> vRes(n * n);
+
+    mat vAMat(vA.data(), n, n, false, true);
+    mat vBMat(vB.data(), n, n, false, true);
+    mat vResMat(vRes.data(), n, n, false, true);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vResMat = vAMat + vBMat;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(Add2dAux_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+// Round trips: the buffer owned by one library is handed to the other
+// one, which computes into memory owned by the first.
+
+#if defined(HAS_XTENSOR) && defined(HAS_EIGEN)
+void RoundTripEigenMap2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+    using row_map = Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>;
+
+    xtensor<double, 2> vA = random::rand<double>({state.range(0), state.range(0)});
+    xtensor<double, 2> vB = random::rand<double>({state.range(0), state.range(0)});
+    xtensor<double, 2> vRes({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        row_map vAMap(vA.data(), state.range(0), state.range(0));
+        row_map vBMap(vB.data(), state.range(0), state.range(0));
+        row_map vResMap(vRes.data(), state.range(0), state.range(0));
+        vResMap.noalias() = vAMap + vBMap;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(RoundTripEigenMap2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void RoundTripAdapt2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    MatrixXd vA = MatrixXd::Random(state.range(0), state.range(0));
+    MatrixXd vB = MatrixXd::Random(state.range(0), state.range(0));
+    MatrixXd vRes(state.range(0), state.range(0));
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::array<std::size_t, 2> vShape = {n, n};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vAAdapt = xt::adapt(vA.data(), n * n, xt::no_ownership(), vShape, xt::layout_type::column_major);
+        auto vBAdapt = xt::adapt(vB.data(), n * n, xt::no_ownership(), vShape, xt::layout_type::column_major);
+        auto vResAdapt = xt::adapt(vRes.data(), n * n, xt::no_ownership(), vShape, xt::layout_type::column_major);
+        xt::noalias(vResAdapt) = vAAdapt + vBAdapt;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(RoundTripAdapt2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#if defined(HAS_XTENSOR) && defined(HAS_ARMADILLO)
+void RoundTripAux2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vA = random::rand<double>({state.range(0), state.range(0)});
+    xtensor<double, 2> vB = random::rand<double>({state.range(0), state.range(0)});
+    xtensor<double, 2> vRes({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        arma::mat vAMat(vA.data(), n, n, false, true);
+        arma::mat vBMat(vB.data(), n, n, false, true);
+        arma::mat vResMat(vRes.data(), n, n, false, true);
+        vResMat = vAMat + vBMat;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(RoundTripAux2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void RoundTripAdapt2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    mat vA = randu<mat>(n, n);
+    mat vB = randu<mat>(n, n);
+    mat vRes(n, n);
+    std::array<std::size_t, 2> vShape = {n, n};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vAAdapt = xt::adapt(vA.memptr(), n * n, xt::no_ownership(), vShape, xt::layout_type::column_major);
+        auto vBAdapt = xt::adapt(vB.memptr(), n * n, xt::no_ownership(), vShape, xt::layout_type::column_major);
+        auto vResAdapt = xt::adapt(vRes.memptr(), n * n, xt::no_ownership(), vShape, xt::layout_type::column_major);
+        xt::noalias(vResAdapt) = vAAdapt + vBAdapt;
+        benchmark::DoNotOptimize(vRes.memptr());
+    }
+}
+BENCHMARK(RoundTripAdapt2D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#undef RANGE
+#undef MULTIPLIER
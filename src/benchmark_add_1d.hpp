@@ -9,6 +9,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+#include "latency.hpp"
+#include "throughput.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -47,18 +51,23 @@ static_assert(false, "NOT VECTORIZING");
 #ifdef HAS_XTENSOR
 void Add1D_XTensor(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     using namespace xt;
 
     xtensor<double, 1> a = random::rand<double>({state.range(0)});
     xtensor<double, 1> b = random::rand<double>({state.range(0)});
 
+    THROUGHPUT_SETUP_END;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         xtensor<double, 1> res(a + b);
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add1D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add1D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_EIGEN
@@ -67,13 +76,16 @@ void Add1D_Eigen(benchmark::State& state)
     using namespace Eigen;
     VectorXd a = VectorXd::Random(state.range(0));
     VectorXd b = VectorXd::Random(state.range(0));
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         VectorXd res(a + b);
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add1D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add1D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_BLITZ
@@ -82,13 +94,16 @@ void Add1D_Blitz(benchmark::State& state)
     using namespace blitz;
     Array<double, 1> a(state.range(0));
     Array<double, 1> b(state.range(0));
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         Array<double, 1> res(a + b);
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add1D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add1D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_ARMADILLO
@@ -97,28 +112,36 @@ void Add1D_Arma(benchmark::State& state)
     using namespace arma;
     vec a = randu<vec>(state.range(0));
     vec b = randu<vec>(state.range(0));
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         vec res(a + b);
         benchmark::DoNotOptimize(res.memptr());
     }
 }
-BENCHMARK(Add1D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add1D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_PYTHONIC
 void Add1D_Pythonic(benchmark::State &state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     auto x = pythonic::numpy::random::rand(state.range(0));
     auto y = pythonic::numpy::random::rand(state.range(0));
 
+    THROUGHPUT_SETUP_END;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         pythonic::types::ndarray<double, 1> z(x + y);
         benchmark::DoNotOptimize(z.fbegin());
     }
 }
-BENCHMARK(Add1D_Pythonic)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add1D_Pythonic)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #undef RANGE
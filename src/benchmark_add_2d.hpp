@@ -9,6 +9,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+#include "latency.hpp"
+#include "throughput.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -44,18 +48,23 @@
 #ifdef HAS_XTENSOR
 void Add2D_XTensor(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     using namespace xt;
 
     xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
     xtensor<double, 2> b = random::rand<double>({state.range(0), state.range(0)});
 
+    THROUGHPUT_SETUP_END;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         xtensor<double, 2> res(a + b);
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_EIGEN
@@ -64,14 +73,17 @@ void Add2D_Eigen(benchmark::State& state)
     using namespace Eigen;
     MatrixXd a = MatrixXd::Random(state.range(0), state.range(0));
     MatrixXd b = MatrixXd::Random(state.range(0), state.range(0));
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         MatrixXd res(state.range(0), state.range(0));
         res.noalias() = a + b;
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_BLITZ
@@ -80,13 +92,16 @@ void Add2D_Blitz(benchmark::State& state)
     using namespace blitz;
     Array<double, 2> a(state.range(0), state.range(0));
     Array<double, 2> b(state.range(0), state.range(0));
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         Array<double, 2> res(a + b);
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_ARMADILLO
@@ -95,28 +110,36 @@ void Add2D_Arma(benchmark::State& state)
     using namespace arma;
     mat a = randu<mat>(state.range(0), state.range(0));
     mat b = randu<mat>(state.range(0), state.range(0));
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         mat res = a + b;
         benchmark::DoNotOptimize(res.memptr());
     }
 }
-BENCHMARK(Add2D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add2D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_PYTHONIC
 void Add2D_Pythonic(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     auto x = pythonic::numpy::random::rand(state.range(0), state.range(0));
     auto y = pythonic::numpy::random::rand(state.range(0), state.range(0));
 
+    THROUGHPUT_SETUP_END;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         pythonic::types::ndarray<double, 2> z = x + y;
         benchmark::DoNotOptimize(z.fbegin());
     }
 }
-BENCHMARK(Add2D_Pythonic)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add2D_Pythonic)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #undef RANGE
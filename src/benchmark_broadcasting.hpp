@@ -9,6 +9,9 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+#include "throughput.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -31,33 +34,39 @@
 #ifdef HAS_XTENSOR
 void Add3d2dBroadcasting_XTensor(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     using namespace xt;
 
     xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
     xtensor<double, 2> b = random::rand<double>({state.range(0), state.range(0)});
 
+    THROUGHPUT_SETUP_END;
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         xtensor<double, 3> res(a + b);
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK(Add3d2dBroadcasting_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Add3d2dBroadcasting_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_PYTHONIC
 void pythonic_broadcasting(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     auto x = pythonic::numpy::random::rand(state.range(0), state.range(0), state.range(0));
     auto y = pythonic::numpy::random::rand(state.range(0), state.range(0));
 
+    THROUGHPUT_SETUP_END;
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         pythonic::types::ndarray<double, 3> z = x + y;
         benchmark::DoNotOptimize(z.fbegin());
     }
 }
-BENCHMARK(pythonic_broadcasting)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(pythonic_broadcasting)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #undef SZ
@@ -9,6 +9,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+#include "latency.hpp"
+#include "throughput.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -32,81 +36,104 @@
 #ifdef HAS_XTENSOR
 void Construct2D_XTensor(benchmark::State& state)
 {
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         xt::xtensor<double, 2> vTensor({state.range(0), state.range(0)});
         benchmark::DoNotOptimize(vTensor);
     }
 }
-BENCHMARK(Construct2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Construct2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_EIGEN
 void Construct2D_Eigen(benchmark::State& state)
 {
     using namespace Eigen;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         MatrixXd vMatrix(state.range(0), state.range(0));
         benchmark::DoNotOptimize(vMatrix);
     }
 }
-BENCHMARK(Construct2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Construct2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_BLITZ
 void Construct2D_Blitz(benchmark::State& state)
 {
     using namespace blitz;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         Array<double, 2> vArray(state.range(0), state.range(0));
         benchmark::DoNotOptimize(vArray);
     }
 }
-BENCHMARK(Construct2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(Construct2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_XTENSOR
+// Draws from an engine of the default type owned by the thread, since the
+// default engine of xtensor is shared by all the threads in throughput mode.
 void ConstructRandom2D_XTensor(benchmark::State& state)
 {
+    xt::random::default_engine_type vEngine;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
-        xt::xtensor<double, 2> vTensor = xt::random::rand<double>({state.range(0), state.range(0)});
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
+        xt::xtensor<double, 2> vTensor = xt::random::rand<double>({state.range(0), state.range(0)}, 0.0, 1.0, vEngine);
         benchmark::DoNotOptimize(vTensor);
     }
 }
-BENCHMARK(ConstructRandom2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(ConstructRandom2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_EIGEN
 void ConstructRandom2D_Eigen(benchmark::State& state)
 {
     using namespace Eigen;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         MatrixXd vMatrix = MatrixXd::Random(state.range(0), state.range(0));
         benchmark::DoNotOptimize(vMatrix);
     }
 }
-BENCHMARK(ConstructRandom2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(ConstructRandom2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 
 #ifdef HAS_XTENSOR
 void ConstructView2d_XTensor(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     using namespace xt;
 
     xtensor<double,2> vA = random::rand<double>({state.range(0), state.range(0)});
 
+    THROUGHPUT_SETUP_END;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         auto vAView = xt::view(vA, all(), all());
         benchmark::DoNotOptimize(vAView);
     }
 }
-BENCHMARK(ConstructView2d_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(ConstructView2d_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_EIGEN
@@ -115,13 +142,16 @@ void ConstructView2d_Eigen(benchmark::State& state)
     using namespace Eigen;
     MatrixXd vA = MatrixXd::Random(state.range(0), state.range(0));
 
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         auto vAView = vA.topLeftCorner(state.range(0), state.range(0));
         benchmark::DoNotOptimize(vAView);
     }
 }
-BENCHMARK(ConstructView2d_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK(ConstructView2d_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE)->Apply(throughput_threads);
 #endif
 
 #undef RANGE
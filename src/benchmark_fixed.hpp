@@ -9,6 +9,10 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+#include "latency.hpp"
+#include "throughput.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -26,22 +30,27 @@
 template <std::size_t N, std::size_t M>
 void Add2dFixed_XTensor(benchmark::State& state)
 {
+    THROUGHPUT_SETUP_BEGIN;
     using namespace xt;
 
     xtensor_fixed<double, xshape<N, M>> a = random::rand<double>({N, M});
     xtensor_fixed<double, xshape<N, M>> b = random::rand<double>({N, M});
 
+    THROUGHPUT_SETUP_END;
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         xtensor_fixed<double, xshape<N, M>> res;
         xt::noalias(res) = a + b;
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 3, 3);
-BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 8, 8);
-BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 64, 64);
-BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 512, 512);
+BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 3, 3)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 8, 8)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 64, 64)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(Add2dFixed_XTensor, 512, 512)->Apply(throughput_threads);
 #endif
 
 #ifdef HAS_EIGEN
@@ -52,14 +61,17 @@ void Add2dFixed_Eigen(benchmark::State& state)
     Matrix<double, N, M> a = Matrix<double, N, N>::Random(N, M);
     Matrix<double, N, M> b = Matrix<double, N, N>::Random(N, M);
 
+    LATENCY_HISTOGRAM(state);
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
+        LATENCY_SCOPE;
         Matrix<double, N, M> res;
         res.noalias() = a + b;
         benchmark::DoNotOptimize(res.data());
     }
 }
-BENCHMARK_TEMPLATE(Add2dFixed_Eigen, 3, 3);
-BENCHMARK_TEMPLATE(Add2dFixed_Eigen, 8, 8);
-BENCHMARK_TEMPLATE(Add2dFixed_Eigen, 64, 64);
+BENCHMARK_TEMPLATE(Add2dFixed_Eigen, 3, 3)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(Add2dFixed_Eigen, 8, 8)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(Add2dFixed_Eigen, 64, 64)->Apply(throughput_threads);
 #endif
@@ -0,0 +1,535 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "allocation_counter.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define HAS_POSIX_IO 1
+#endif
+
+#ifdef HAS_XTENSOR
+#include "xtensor/xio.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xadapt.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xcsv.hpp"
+#endif
+
+#ifdef HAS_EIGEN
+#include <Eigen/Dense>
+#include <Eigen/Core>
+#endif
+
+#ifdef HAS_ARMADILLO
+#include <armadillo>
+#endif
+
+#ifdef HAS_POSIX_IO
+
+// Number of doubles: from 1 KB to 1 GB. CSV is text and an order of
+// magnitude slower, so it stops at 32 MB.
+#define IO_MIN (1 << 7)
+#define IO_MAX (1 << 27)
+#define IO_CSV_MAX (1 << 22)
+#define IO_CSV_COLUMNS 16
+#define MULTIPLIER 32
+
+// Registered without cold_cache_register and COLD_CACHE_SCOPE: the I/O
+// benchmarks have their own cold variants, and a cache eviction plus a
+// fixed iteration count would write the 1 GB files hundreds of times.
+#define IO_BENCHMARK(n) \
+    static ::benchmark::internal::Benchmark* io_benchmark_##n BENCHMARK_UNUSED = ::benchmark::RegisterBenchmark(#n, n)
+
+// Registers (size, cold) pairs; cold runs evict the file from the page
+// cache before every iteration, which is only possible with posix_fadvise.
+template <std::int64_t Max, bool WithCold>
+void io_args(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"n", "cold"});
+    for (std::int64_t n = IO_MIN; n <= Max; n *= MULTIPLIER)
+    {
+        b->Args({n, 0});
+#ifdef POSIX_FADV_DONTNEED
+        if (WithCold)
+        {
+            b->Args({n, 1});
+        }
+#endif
+    }
+}
+
+// Creates an empty temporary file and returns its path. If it cannot be
+// created, the benchmark is skipped with an error and the path is empty.
+inline std::string io_temp_path(benchmark::State& state, const std::string& suffix)
+{
+    const char* dir = std::getenv("TMPDIR");
+    std::string pattern = std::string(dir != nullptr ? dir : "/tmp") + "/xtensor_benchmark_XXXXXX" + suffix;
+    std::vector<char> buffer(pattern.begin(), pattern.end());
+    buffer.push_back('\0');
+    int fd = mkstemps(buffer.data(), static_cast<int>(suffix.size()));
+    if (fd == -1)
+    {
+        state.SkipWithError("could not create a temporary file");
+        return std::string();
+    }
+    close(fd);
+    return std::string(buffer.data());
+}
+
+inline void io_drop_cache(const std::string& path)
+{
+#ifdef POSIX_FADV_DONTNEED
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd != -1)
+    {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+inline void io_prepare_iteration(benchmark::State& state, const std::string& path)
+{
+    if (state.range(1) != 0)
+    {
+        state.PauseTiming();
+        io_drop_cache(path);
+        state.ResumeTiming();
+    }
+}
+
+inline void io_report(benchmark::State& state, std::size_t bytes, std::size_t allocations)
+{
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(bytes));
+    report_allocations(state, allocations);
+}
+
+inline void io_write_raw(const std::string& path, const double* data, std::size_t size)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size * sizeof(double)));
+}
+
+inline void io_read_raw(const std::string& path, double* data, std::size_t size)
+{
+    std::ifstream in(path, std::ios::binary);
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size * sizeof(double)));
+}
+
+#ifdef HAS_XTENSOR
+void DumpNpy_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".npy");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 1> a = xt::random::rand<double>({state.range(0)});
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        xt::dump_npy(path, a);
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(DumpNpy_XTensor)->Apply(io_args<IO_MAX, false>);
+
+void LoadNpy_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".npy");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 1> a = xt::random::rand<double>({state.range(0)});
+    xt::dump_npy(path, a);
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        auto res = xt::load_npy<double>(path);
+        benchmark::DoNotOptimize(res.data());
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadNpy_XTensor)->Apply(io_args<IO_MAX, true>);
+
+// Parses the NPY header just enough to find the data offset and the 1-D
+// shape, so that the payload can be adapted in place.
+inline bool npy_parse_header(const char* buffer, std::size_t length, std::size_t& offset, std::size_t& size)
+{
+    if (length < 10 || std::memcmp(buffer, "\x93NUMPY", 6) != 0)
+    {
+        return false;
+    }
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(buffer);
+    std::size_t header_length = 0;
+    std::size_t prefix = 0;
+    if (bytes[6] == 1)
+    {
+        header_length = bytes[8] | (std::size_t(bytes[9]) << 8);
+        prefix = 10;
+    }
+    else
+    {
+        if (length < 12)
+        {
+            return false;
+        }
+        header_length = bytes[8] | (std::size_t(bytes[9]) << 8) | (std::size_t(bytes[10]) << 16) | (std::size_t(bytes[11]) << 24);
+        prefix = 12;
+    }
+    offset = prefix + header_length;
+    std::string header(buffer + prefix, header_length);
+    std::size_t pos = header.find("'shape': (");
+    if (pos == std::string::npos || offset > length)
+    {
+        return false;
+    }
+    size = std::strtoull(header.c_str() + pos + 10, nullptr, 10);
+    return offset + size * sizeof(double) <= length;
+}
+
+// mmap + xt::adapt: the load itself is free, the page faults are paid by
+// the reduction that touches every element. The reduction is also applied
+// after load_npy below so that both kernels do the same work.
+void MmapNpy_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".npy");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 1> a = xt::random::rand<double>({state.range(0)});
+    xt::dump_npy(path, a);
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        int fd = open(path.c_str(), O_RDONLY);
+        struct stat st;
+        if (fd == -1 || fstat(fd, &st) != 0)
+        {
+            state.SkipWithError("could not open npy file");
+            if (fd != -1)
+            {
+                close(fd);
+            }
+            break;
+        }
+        std::size_t length = static_cast<std::size_t>(st.st_size);
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        const char* buffer = static_cast<const char*>(mapped);
+        std::size_t offset = 0, size = 0;
+        if (mapped == MAP_FAILED || !npy_parse_header(buffer, length, offset, size))
+        {
+            state.SkipWithError("could not map npy file");
+            if (mapped != MAP_FAILED)
+            {
+                munmap(mapped, length);
+            }
+            close(fd);
+            break;
+        }
+        std::array<std::size_t, 1> shape = {size};
+        auto res = xt::adapt(reinterpret_cast<const double*>(buffer + offset), size, xt::no_ownership(), shape);
+        double total = xt::sum(res)();
+        benchmark::DoNotOptimize(total);
+        munmap(mapped, length);
+        close(fd);
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(MmapNpy_XTensor)->Apply(io_args<IO_MAX, true>);
+
+void LoadNpySum_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".npy");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 1> a = xt::random::rand<double>({state.range(0)});
+    xt::dump_npy(path, a);
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        auto res = xt::load_npy<double>(path);
+        double total = xt::sum(res)();
+        benchmark::DoNotOptimize(total);
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadNpySum_XTensor)->Apply(io_args<IO_MAX, true>);
+
+void DumpCsv_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".csv");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 2> a = xt::random::rand<double>({state.range(0) / IO_CSV_COLUMNS, std::int64_t(IO_CSV_COLUMNS)});
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        std::ofstream out(path, std::ios::trunc);
+        xt::dump_csv(out, a);
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(DumpCsv_XTensor)->Apply(io_args<IO_CSV_MAX, false>);
+
+void LoadCsv_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".csv");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 2> a = xt::random::rand<double>({state.range(0) / IO_CSV_COLUMNS, std::int64_t(IO_CSV_COLUMNS)});
+    {
+        std::ofstream out(path, std::ios::trunc);
+        xt::dump_csv(out, a);
+    }
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        std::ifstream in(path);
+        auto res = xt::load_csv<double>(in);
+        benchmark::DoNotOptimize(res.data());
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadCsv_XTensor)->Apply(io_args<IO_CSV_MAX, true>);
+
+void DumpRaw_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".bin");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 1> a = xt::random::rand<double>({state.range(0)});
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_write_raw(path, a.data(), a.size());
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(DumpRaw_XTensor)->Apply(io_args<IO_MAX, false>);
+
+void LoadRaw_XTensor(benchmark::State& state)
+{
+    std::string path = io_temp_path(state, ".bin");
+    if (path.empty())
+    {
+        return;
+    }
+    xt::xtensor<double, 1> a = xt::random::rand<double>({state.range(0)});
+    io_write_raw(path, a.data(), a.size());
+    std::array<std::size_t, 1> shape = {a.size()};
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        xt::xtensor<double, 1> res(shape);
+        io_read_raw(path, res.data(), res.size());
+        benchmark::DoNotOptimize(res.data());
+    }
+    io_report(state, a.size() * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadRaw_XTensor)->Apply(io_args<IO_MAX, true>);
+#endif
+
+#ifdef HAS_EIGEN
+void DumpRaw_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    std::string path = io_temp_path(state, ".bin");
+    if (path.empty())
+    {
+        return;
+    }
+    VectorXd a = VectorXd::Random(state.range(0));
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_write_raw(path, a.data(), static_cast<std::size_t>(a.size()));
+    }
+    io_report(state, static_cast<std::size_t>(a.size()) * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(DumpRaw_Eigen)->Apply(io_args<IO_MAX, false>);
+
+void LoadRaw_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    std::string path = io_temp_path(state, ".bin");
+    if (path.empty())
+    {
+        return;
+    }
+    VectorXd a = VectorXd::Random(state.range(0));
+    io_write_raw(path, a.data(), static_cast<std::size_t>(a.size()));
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        VectorXd res(state.range(0));
+        io_read_raw(path, res.data(), static_cast<std::size_t>(res.size()));
+        benchmark::DoNotOptimize(res.data());
+    }
+    io_report(state, static_cast<std::size_t>(a.size()) * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadRaw_Eigen)->Apply(io_args<IO_MAX, true>);
+#endif
+
+#ifdef HAS_ARMADILLO
+void DumpBinary_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::string path = io_temp_path(state, ".bin");
+    if (path.empty())
+    {
+        return;
+    }
+    vec a = randu<vec>(state.range(0));
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        a.save(path, arma_binary);
+    }
+    io_report(state, a.n_elem * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(DumpBinary_Arma)->Apply(io_args<IO_MAX, false>);
+
+void LoadBinary_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::string path = io_temp_path(state, ".bin");
+    if (path.empty())
+    {
+        return;
+    }
+    vec a = randu<vec>(state.range(0));
+    a.save(path, arma_binary);
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        vec res;
+        res.load(path, arma_binary);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+    io_report(state, a.n_elem * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadBinary_Arma)->Apply(io_args<IO_MAX, true>);
+
+void DumpCsv_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::string path = io_temp_path(state, ".csv");
+    if (path.empty())
+    {
+        return;
+    }
+    mat a = randu<mat>(state.range(0) / IO_CSV_COLUMNS, IO_CSV_COLUMNS);
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        a.save(path, csv_ascii);
+    }
+    io_report(state, a.n_elem * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(DumpCsv_Arma)->Apply(io_args<IO_CSV_MAX, false>);
+
+void LoadCsv_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    std::string path = io_temp_path(state, ".csv");
+    if (path.empty())
+    {
+        return;
+    }
+    mat a = randu<mat>(state.range(0) / IO_CSV_COLUMNS, IO_CSV_COLUMNS);
+    a.save(path, csv_ascii);
+
+    std::size_t allocations = current_allocation_count();
+    for (auto _ : state)
+    {
+        io_prepare_iteration(state, path);
+        mat res;
+        res.load(path, csv_ascii);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+    io_report(state, a.n_elem * sizeof(double), allocations);
+    std::remove(path.c_str());
+}
+IO_BENCHMARK(LoadCsv_Arma)->Apply(io_args<IO_CSV_MAX, true>);
+#endif
+
+#undef IO_MIN
+#undef IO_MAX
+#undef IO_CSV_MAX
+#undef IO_CSV_COLUMNS
+#undef MULTIPLIER
+#undef IO_BENCHMARK
+
+#endif
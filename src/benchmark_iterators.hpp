@@ -9,6 +9,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -36,6 +38,7 @@ void IterateWhole2D_XTensor(benchmark::State& state)
     xt::xtensor<double, 2> vTensor({state.range(0), state.range(0)});
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         double vTmp = 0.0;
         for (auto it = vTensor.begin(); it != vTensor.end(); ++it) {
             vTmp += *it;
@@ -70,6 +73,7 @@ void IterateWhole2D_Blitz(benchmark::State& state)
     Array<double, 2> vArray(state.range(0), state.range(0));
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         double vTmp = 0.0;
         for (auto it = vArray.begin(); it != vArray.end(); ++it) {
             vTmp += *it;
@@ -0,0 +1,374 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include <benchmark/benchmark.h>
+
+#include "cold_cache.hpp"
+
+#ifdef HAS_XTENSOR
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xio.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xmanipulation.hpp"
+#endif
+
+#ifdef HAS_EIGEN
+#include <Eigen/Dense>
+#include <Eigen/Core>
+#endif
+
+#ifdef HAS_ARMADILLO
+#include <armadillo>
+#endif
+
+// Goes up to 4096 x 4096 (128 MB) so that the largest size does not fit
+// in the last level cache, where naive transposes degrade.
+#define RANGE 3, 4096
+#define RANGE_3D 3, 256
+#define MULTIPLIER 8
+#define BLOCK_SIZE 32
+
+
+#ifdef HAS_XTENSOR
+void Transpose2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res(transpose(a));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Transpose2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Transpose2dLoop_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res({n, n});
+        const double* src = a.data();
+        double* dst = res.data();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                dst[j * n + i] = src[i * n + j];
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Transpose2dLoop_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Transpose2dBlocked_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res({n, n});
+        const double* src = a.data();
+        double* dst = res.data();
+        for (std::size_t ib = 0; ib < n; ib += BLOCK_SIZE)
+        {
+            std::size_t ie = std::min(ib + BLOCK_SIZE, n);
+            for (std::size_t jb = 0; jb < n; jb += BLOCK_SIZE)
+            {
+                std::size_t je = std::min(jb + BLOCK_SIZE, n);
+                for (std::size_t i = ib; i < ie; ++i)
+                {
+                    for (std::size_t j = jb; j < je; ++j)
+                    {
+                        dst[j * n + i] = src[i * n + j];
+                    }
+                }
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Transpose2dBlocked_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+// Cache-oblivious transpose: splits the larger dimension in two until the
+// tile fits in BLOCK_SIZE x BLOCK_SIZE.
+inline void transpose_recursive(const double* src, double* dst, std::size_t n,
+                                std::size_t i0, std::size_t i1, std::size_t j0, std::size_t j1)
+{
+    std::size_t di = i1 - i0;
+    std::size_t dj = j1 - j0;
+    if (di <= BLOCK_SIZE && dj <= BLOCK_SIZE)
+    {
+        for (std::size_t i = i0; i < i1; ++i)
+        {
+            for (std::size_t j = j0; j < j1; ++j)
+            {
+                dst[j * n + i] = src[i * n + j];
+            }
+        }
+    }
+    else if (di >= dj)
+    {
+        std::size_t im = i0 + di / 2;
+        transpose_recursive(src, dst, n, i0, im, j0, j1);
+        transpose_recursive(src, dst, n, im, i1, j0, j1);
+    }
+    else
+    {
+        std::size_t jm = j0 + dj / 2;
+        transpose_recursive(src, dst, n, i0, i1, j0, jm);
+        transpose_recursive(src, dst, n, i0, i1, jm, j1);
+    }
+}
+
+void Transpose2dRecursive_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res({n, n});
+        transpose_recursive(a.data(), res.data(), n, 0, n, 0, n);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Transpose2dRecursive_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_EIGEN
+void Transpose2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    MatrixXd a = MatrixXd::Random(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        MatrixXd res = a.transpose().eval();
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Transpose2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_ARMADILLO
+void Transpose2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat a = randu<mat>(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        mat res = trans(a);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+}
+BENCHMARK(Transpose2D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_XTENSOR
+void CopyRowToColumnMajor2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2, layout_type::column_major> res(a);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CopyRowToColumnMajor2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void CopyColumnToRowMajor2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2, layout_type::column_major> a = random::rand<double>({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res(a);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CopyColumnToRowMajor2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_EIGEN
+void CopyRowToColumnMajor2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    Matrix<double, Dynamic, Dynamic, RowMajor> a = MatrixXd::Random(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        MatrixXd res(a);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CopyRowToColumnMajor2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_XTENSOR
+void Flatten2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 1> res(flatten(a));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Flatten2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Ravel2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 1> res(ravel<layout_type::row_major>(a));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Ravel2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Ravel2dColumnMajor_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 1> res(ravel<layout_type::column_major>(a));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Ravel2dColumnMajor_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void Reshape2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::array<std::size_t, 1> vShape = {n * n};
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 1> res(reshape_view(a, vShape));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Reshape2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_EIGEN
+void Reshape2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    MatrixXd a = MatrixXd::Random(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        VectorXd res(Map<const VectorXd>(a.data(), a.size()));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Reshape2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_ARMADILLO
+void Reshape2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat a = randu<mat>(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vec res = vectorise(a);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+}
+BENCHMARK(Reshape2D_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_XTENSOR
+void SwapAxes3D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res(swapaxes(a, 1, 2));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(SwapAxes3D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE_3D);
+
+void SwapAxes3dOuter_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res(swapaxes(a, 0, 2));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(SwapAxes3dOuter_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE_3D);
+#endif
+
+#undef BLOCK_SIZE
+#undef RANGE
+#undef RANGE_3D
+#undef MULTIPLIER
@@ -0,0 +1,383 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "cold_cache.hpp"
+#include "throughput.hpp"
+
+#ifdef HAS_XTENSOR
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xio.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+#endif
+
+#ifdef HAS_EIGEN
+#include <Eigen/Dense>
+#include <Eigen/Core>
+#endif
+
+#ifdef HAS_ARMADILLO
+#include <armadillo>
+#endif
+
+#define RANGE 3, 1000
+#define MULTIPLIER 8
+#define THREADED_SIZE 1000
+
+// Every kernel generates into a preallocated buffer, so that only the
+// generation is timed. Throughput is reported in items per second.
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as
+// 1, 2, 3"), a counter-based engine used as a reference point.
+class philox4x32
+{
+public:
+
+    using result_type = std::uint32_t;
+
+    static constexpr result_type min()
+    {
+        return 0;
+    }
+
+    static constexpr result_type max()
+    {
+        return 0xFFFFFFFF;
+    }
+
+    explicit philox4x32(std::uint64_t seed = 0)
+    {
+        this->seed(seed);
+    }
+
+    void seed(std::uint64_t seed)
+    {
+        m_key = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+        m_counter = {0, 0, 0, 0};
+        m_index = 4;
+    }
+
+    result_type operator()()
+    {
+        if (m_index == 4)
+        {
+            generate();
+            m_index = 0;
+        }
+        return m_output[m_index++];
+    }
+
+private:
+
+    void generate()
+    {
+        std::array<std::uint32_t, 4> ctr = m_counter;
+        std::array<std::uint32_t, 2> key = m_key;
+        for (int round = 0; round < 10; ++round)
+        {
+            std::uint64_t p0 = std::uint64_t(0xD2511F53) * ctr[0];
+            std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * ctr[2];
+            ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+                   static_cast<std::uint32_t>(p1),
+                   static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+                   static_cast<std::uint32_t>(p0)};
+            key[0] += 0x9E3779B9;
+            key[1] += 0xBB67AE85;
+        }
+        m_output = ctr;
+        for (std::size_t i = 0; i < 4 && ++m_counter[i] == 0; ++i)
+        {
+        }
+    }
+
+    std::array<std::uint32_t, 4> m_counter;
+    std::array<std::uint32_t, 4> m_output;
+    std::array<std::uint32_t, 2> m_key;
+    std::size_t m_index;
+};
+
+// Seeds of the per-thread streams of the multi-threaded kernels
+inline std::uint64_t next_stream_seed()
+{
+    static std::atomic<std::uint64_t> seed(0);
+    return 0x9E3779B97F4A7C15ull * ++seed;
+}
+
+#ifdef HAS_XTENSOR
+void RandomUniform_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vRes({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::rand<double>({n, n});
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK(RandomUniform_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void RandomUniformLoop_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vRes({n, n});
+    std::mt19937 vEngine;
+    std::uniform_real_distribution<double> vDist(0.0, 1.0);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        for (auto& v : vRes)
+        {
+            v = vDist(vEngine);
+        }
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK(RandomUniformLoop_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+template <class E>
+void RandomUniformEngine_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vRes({n, n});
+    E vEngine;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::rand<double>({n, n}, 0.0, 1.0, vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK_TEMPLATE(RandomUniformEngine_XTensor, std::mt19937)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomUniformEngine_XTensor, std::mt19937_64)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomUniformEngine_XTensor, std::minstd_rand)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomUniformEngine_XTensor, philox4x32)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void RandomNormal_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vRes({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::randn<double>({n, n});
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK(RandomNormal_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+template <class E>
+void RandomNormalEngine_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vRes({n, n});
+    E vEngine;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::randn<double>({n, n}, 0.0, 1.0, vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK_TEMPLATE(RandomNormalEngine_XTensor, std::mt19937)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomNormalEngine_XTensor, std::mt19937_64)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomNormalEngine_XTensor, std::minstd_rand)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomNormalEngine_XTensor, philox4x32)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+template <class E>
+void RandomInt_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<int, 2> vRes({n, n});
+    E vEngine;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::randint<int>({n, n}, 0, 100, vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK_TEMPLATE(RandomInt_XTensor, std::mt19937)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomInt_XTensor, std::mt19937_64)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomInt_XTensor, std::minstd_rand)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomInt_XTensor, philox4x32)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+template <class E>
+void RandomBinomial_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<int, 2> vRes({n, n});
+    E vEngine;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::binomial<int>({n, n}, 10, 0.3, vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK_TEMPLATE(RandomBinomial_XTensor, std::mt19937)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomBinomial_XTensor, std::mt19937_64)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomBinomial_XTensor, std::minstd_rand)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomBinomial_XTensor, philox4x32)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+template <class E>
+void RandomShuffle_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 1> vRes = arange<double>(static_cast<double>(n * n));
+    E vEngine;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        random::shuffle(vRes, vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK_TEMPLATE(RandomShuffle_XTensor, std::mt19937)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomShuffle_XTensor, std::mt19937_64)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomShuffle_XTensor, std::minstd_rand)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomShuffle_XTensor, philox4x32)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+// permutation returns a new tensor, the allocation is part of the timing
+template <class E>
+void RandomPermutation_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    E vEngine;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        auto vRes = random::permutation<std::ptrdiff_t>(static_cast<std::ptrdiff_t>(n * n), vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * n * n));
+}
+BENCHMARK_TEMPLATE(RandomPermutation_XTensor, std::mt19937)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomPermutation_XTensor, std::mt19937_64)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomPermutation_XTensor, std::minstd_rand)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+BENCHMARK_TEMPLATE(RandomPermutation_XTensor, philox4x32)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+// Every thread owns its buffer and an independently seeded engine; runs on
+// several threads in throughput mode.
+template <class E>
+void RandomUniformThreaded_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vRes({n, n});
+    E vEngine(static_cast<typename E::result_type>(next_stream_seed()));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(vRes) = random::rand<double>({n, n}, 0.0, 1.0, vEngine);
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK_TEMPLATE(RandomUniformThreaded_XTensor, std::mt19937)->Arg(THREADED_SIZE)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(RandomUniformThreaded_XTensor, std::mt19937_64)->Arg(THREADED_SIZE)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(RandomUniformThreaded_XTensor, std::minstd_rand)->Arg(THREADED_SIZE)->Apply(throughput_threads);
+BENCHMARK_TEMPLATE(RandomUniformThreaded_XTensor, philox4x32)->Arg(THREADED_SIZE)->Apply(throughput_threads);
+#endif
+
+#ifdef HAS_EIGEN
+void RandomUniform_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    MatrixXd vRes(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.setRandom();
+        benchmark::DoNotOptimize(vRes.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.size()));
+}
+BENCHMARK(RandomUniform_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_ARMADILLO
+void RandomUniform_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat vRes(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.randu();
+        benchmark::DoNotOptimize(vRes.memptr());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.n_elem));
+}
+BENCHMARK(RandomUniform_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void RandomNormal_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat vRes(state.range(0), state.range(0));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.randn();
+        benchmark::DoNotOptimize(vRes.memptr());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * vRes.n_elem));
+}
+BENCHMARK(RandomNormal_Arma)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#undef RANGE
+#undef MULTIPLIER
+#undef THREADED_SIZE
@@ -9,12 +9,15 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xview.hpp"
 #endif
 
 #ifdef HAS_EIGEN
@@ -37,6 +40,7 @@ void AssignScalar2D_XTensor(benchmark::State& state)
     double value = 0.0;
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         vTensor.fill(value);
         value += 1.0;
         benchmark::DoNotOptimize(vTensor.data());
@@ -53,6 +57,7 @@ void AssignScalar2D_Eigen(benchmark::State& state)
     double value = 0.0;
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         vMatrix.fill(value);
         value += 1.0;
         benchmark::DoNotOptimize(vMatrix);
@@ -69,6 +74,7 @@ void AssignScalar2D_Blitz(benchmark::State& state)
     double value = 0.0;
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         vArray = value;
         value += 1.0;
         benchmark::DoNotOptimize(vArray);
@@ -77,6 +83,86 @@ void AssignScalar2D_Blitz(benchmark::State& state)
 BENCHMARK(AssignScalar2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
 #endif
 
+// Fills the central half of each dimension through a view
+
+#ifdef HAS_XTENSOR
+void AssignScalarView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vTensor({n, n});
+    auto vView = xt::view(vTensor, range(lo, hi), range(lo, hi));
+    double value = 0.0;
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vView = value;
+        value += 1.0;
+        benchmark::DoNotOptimize(vTensor.data());
+    }
+}
+BENCHMARK(AssignScalarView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void FillScalarView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vTensor({n, n});
+    auto vView = xt::view(vTensor, range(lo, hi), range(lo, hi));
+    double value = 0.0;
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vView.fill(value);
+        value += 1.0;
+        benchmark::DoNotOptimize(vTensor.data());
+    }
+}
+BENCHMARK(FillScalarView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_EIGEN
+void AssignScalarView2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    Index n = state.range(0);
+    Index lo = n / 4, size = (n + 1) / 2;
+    Matrix<double, Dynamic, Dynamic, RowMajor> vMatrix(n, n);
+    double value = 0.0;
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vMatrix.block(lo, lo, size, size).setConstant(value);
+        value += 1.0;
+        benchmark::DoNotOptimize(vMatrix.data());
+    }
+}
+BENCHMARK(AssignScalarView2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_BLITZ
+void AssignScalarView2D_Blitz(benchmark::State& state)
+{
+    using namespace blitz;
+    int n = static_cast<int>(state.range(0));
+    int lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    Array<double, 2> vArray(n, n);
+    double value = 0.0;
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vArray(Range(lo, hi - 1), Range(lo, hi - 1)) = value;
+        value += 1.0;
+        benchmark::DoNotOptimize(vArray.data());
+    }
+}
+BENCHMARK(AssignScalarView2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
 #undef RANGE
 #undef MULTIPLIER
 
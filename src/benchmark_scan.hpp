@@ -0,0 +1,516 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "cold_cache.hpp"
+
+#ifdef HAS_XTENSOR
+#include "xtensor/xio.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xstrided_view.hpp"
+#endif
+
+#ifdef HAS_EIGEN
+#include <Eigen/Dense>
+#include <Eigen/Core>
+#endif
+
+#ifdef HAS_ARMADILLO
+#include <armadillo>
+#endif
+
+#ifdef HAS_PYTHONIC
+#include <pythonic/core.hpp>
+#include <pythonic/python/core.hpp>
+#include <pythonic/types/ndarray.hpp>
+#include <pythonic/numpy/random/rand.hpp>
+#include <pythonic/numpy/cumsum.hpp>
+#include <pythonic/numpy/cumprod.hpp>
+#include <pythonic/numpy/diff.hpp>
+#endif
+
+// Scans (cumsum, cumprod) and finite differences (diff, gradient, trapz)
+// carry a dependency along the axis they run on. Every kernel runs along
+// each axis of an n x n (x n) tensor; the axis is the row-major one, i.e.
+// the last axis is the contiguous one. The column-major libraries run
+// along the dimension with the same memory layout, so that a given axis
+// always compares the same access pattern.
+#define RANGE_2D_MAX 1000
+#define RANGE_3D_MAX 128
+#define SCAN_MIN 3
+#define MULTIPLIER 8
+
+// Registers (n, axis) pairs for the sizes Range(SCAN_MIN, Max) would give.
+template <std::size_t Dim, std::int64_t Max>
+void scan_args(benchmark::internal::Benchmark* b)
+{
+    b->ArgNames({"n", "axis"});
+    std::vector<std::int64_t> sizes = {SCAN_MIN};
+    for (std::int64_t n = MULTIPLIER; n < Max; n *= MULTIPLIER)
+    {
+        sizes.push_back(n);
+    }
+    sizes.push_back(Max);
+    for (std::int64_t n : sizes)
+    {
+        for (std::int64_t axis = 0; axis < static_cast<std::int64_t>(Dim); ++axis)
+        {
+            b->Args({n, axis});
+        }
+    }
+}
+
+
+#ifdef HAS_XTENSOR
+// Hand-written prefix sum over the (outer, length, inner) decomposition of
+// a row-major tensor around `axis`. The innermost loop adds whole
+// contiguous rows and vectorizes, except along the last axis where the
+// carried dependency leaves a scalar loop.
+template <std::size_t N>
+void prefix_sum(const xt::xtensor<double, N>& a, std::size_t axis, xt::xtensor<double, N>& res)
+{
+    std::size_t outer = 1;
+    std::size_t inner = 1;
+    for (std::size_t d = 0; d < axis; ++d)
+    {
+        outer *= a.shape()[d];
+    }
+    for (std::size_t d = axis + 1; d < N; ++d)
+    {
+        inner *= a.shape()[d];
+    }
+    std::size_t length = a.shape()[axis];
+    for (std::size_t o = 0; o < outer; ++o)
+    {
+        const double* src = a.data() + o * length * inner;
+        double* dst = res.data() + o * length * inner;
+        std::copy(src, src + inner, dst);
+        for (std::size_t i = 1; i < length; ++i)
+        {
+            for (std::size_t k = 0; k < inner; ++k)
+            {
+                dst[i * inner + k] = dst[(i - 1) * inner + k] + src[i * inner + k];
+            }
+        }
+    }
+}
+
+// numpy.gradient with unit spacing along `axis`: central differences inside,
+// one-sided differences at both ends. xtensor does not provide it, so
+// it is composed from strided views, as numpy does with slices.
+template <std::size_t N>
+void numpy_gradient(const xt::xtensor<double, N>& a, std::size_t axis, xt::xtensor<double, N>& res)
+{
+    using xt::strided_view;
+    std::ptrdiff_t n = static_cast<std::ptrdiff_t>(a.shape()[axis]);
+    auto along = [axis](auto slice) {
+        xt::xstrided_slice_vector sv(N, xt::all());
+        sv[axis] = slice;
+        return sv;
+    };
+    strided_view(res, along(xt::range(std::ptrdiff_t(1), n - 1))) =
+        0.5 * (strided_view(a, along(xt::range(std::ptrdiff_t(2), n))) -
+               strided_view(a, along(xt::range(std::ptrdiff_t(0), n - 2))));
+    strided_view(res, along(std::ptrdiff_t(0))) = strided_view(a, along(std::ptrdiff_t(1))) -
+                                                  strided_view(a, along(std::ptrdiff_t(0)));
+    strided_view(res, along(n - 1)) = strided_view(a, along(n - 1)) - strided_view(a, along(n - 2));
+}
+
+void CumSum2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res = cumsum(a, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumSum2D_XTensor)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void CumSum3D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res = cumsum(a, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumSum3D_XTensor)->Apply(scan_args<3, RANGE_3D_MAX>);
+
+void CumSum2dLoop_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::size_t axis = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res(a.shape());
+        prefix_sum(a, axis, res);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumSum2dLoop_XTensor)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void CumSum3dLoop_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+    std::size_t axis = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res(a.shape());
+        prefix_sum(a, axis, res);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumSum3dLoop_XTensor)->Apply(scan_args<3, RANGE_3D_MAX>);
+
+// The factors stay close to 1 so that the products of up to 1000 of them
+// neither overflow nor become denormal.
+void CumProd2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)}, 0.999, 1.001);
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res = cumprod(a, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumProd2D_XTensor)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void CumProd3D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)}, 0.999, 1.001);
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res = cumprod(a, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumProd3D_XTensor)->Apply(scan_args<3, RANGE_3D_MAX>);
+
+void Diff2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res = diff(a, 1, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Diff2D_XTensor)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Diff3D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res = diff(a, 1, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Diff3D_XTensor)->Apply(scan_args<3, RANGE_3D_MAX>);
+
+void Gradient2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::size_t axis = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res(a.shape());
+        numpy_gradient(a, axis, res);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Gradient2D_XTensor)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Gradient3D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+    std::size_t axis = static_cast<std::size_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 3> res(a.shape());
+        numpy_gradient(a, axis, res);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Gradient3D_XTensor)->Apply(scan_args<3, RANGE_3D_MAX>);
+
+void Trapz2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 2> a = random::rand<double>({state.range(0), state.range(0)});
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 1> res = trapz(a, 1.0, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Trapz2D_XTensor)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Trapz3D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    xtensor<double, 3> a = random::rand<double>({state.range(0), state.range(0), state.range(0)});
+    std::ptrdiff_t axis = static_cast<std::ptrdiff_t>(state.range(1));
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xtensor<double, 2> res = trapz(a, 1.0, axis);
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Trapz3D_XTensor)->Apply(scan_args<3, RANGE_3D_MAX>);
+#endif
+
+#ifdef HAS_EIGEN
+// Eigen has no cumulative sum. Along axis 0, whole columns are added and
+// vectorize; along axis 1 (down each contiguous column), adding strided
+// rows is several times slower than scanning every column in turn.
+void CumSum2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    Index n = state.range(0);
+    MatrixXd a = MatrixXd::Random(n, n);
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        MatrixXd res(n, n);
+        if (state.range(1) == 0)
+        {
+            res.col(0) = a.col(0);
+            for (Index j = 1; j < n; ++j)
+            {
+                res.col(j) = res.col(j - 1) + a.col(j);
+            }
+        }
+        else
+        {
+            for (Index j = 0; j < n; ++j)
+            {
+                res(0, j) = a(0, j);
+                for (Index i = 1; i < n; ++i)
+                {
+                    res(i, j) = res(i - 1, j) + a(i, j);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(CumSum2D_Eigen)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Diff2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    Index n = state.range(0);
+    MatrixXd a = MatrixXd::Random(n, n);
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        MatrixXd res;
+        if (state.range(1) == 0)
+        {
+            res = a.rightCols(n - 1) - a.leftCols(n - 1);
+        }
+        else
+        {
+            res = a.bottomRows(n - 1) - a.topRows(n - 1);
+        }
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+BENCHMARK(Diff2D_Eigen)->Apply(scan_args<2, RANGE_2D_MAX>);
+#endif
+
+#ifdef HAS_ARMADILLO
+// Dimension 0 of a column-major matrix is the contiguous one, like axis 1
+// of a row-major one.
+inline arma::uword arma_dim(std::int64_t axis)
+{
+    return axis == 1 ? 0 : 1;
+}
+
+void CumSum2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat a = randu<mat>(state.range(0), state.range(0));
+    uword dim = arma_dim(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        mat res = cumsum(a, dim);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+}
+BENCHMARK(CumSum2D_Arma)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void CumProd2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat a = 0.999 + 0.002 * randu<mat>(state.range(0), state.range(0));
+    uword dim = arma_dim(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        mat res = cumprod(a, dim);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+}
+BENCHMARK(CumProd2D_Arma)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Diff2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat a = randu<mat>(state.range(0), state.range(0));
+    uword dim = arma_dim(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        mat res = diff(a, 1, dim);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+}
+BENCHMARK(Diff2D_Arma)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Trapz2D_Arma(benchmark::State& state)
+{
+    using namespace arma;
+    mat a = randu<mat>(state.range(0), state.range(0));
+    uword dim = arma_dim(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        mat res = trapz(a, dim);
+        benchmark::DoNotOptimize(res.memptr());
+    }
+}
+BENCHMARK(Trapz2D_Arma)->Apply(scan_args<2, RANGE_2D_MAX>);
+#endif
+
+#ifdef HAS_PYTHONIC
+void CumSum2D_Pythonic(benchmark::State& state)
+{
+    auto x = pythonic::numpy::random::rand(state.range(0), state.range(0));
+    long axis = static_cast<long>(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        pythonic::types::ndarray<double, 2> z = pythonic::numpy::cumsum(x, axis);
+        benchmark::DoNotOptimize(z.fbegin());
+    }
+}
+BENCHMARK(CumSum2D_Pythonic)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void CumSum3D_Pythonic(benchmark::State& state)
+{
+    auto x = pythonic::numpy::random::rand(state.range(0), state.range(0), state.range(0));
+    long axis = static_cast<long>(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        pythonic::types::ndarray<double, 3> z = pythonic::numpy::cumsum(x, axis);
+        benchmark::DoNotOptimize(z.fbegin());
+    }
+}
+BENCHMARK(CumSum3D_Pythonic)->Apply(scan_args<3, RANGE_3D_MAX>);
+
+void CumProd2D_Pythonic(benchmark::State& state)
+{
+    auto x = pythonic::numpy::random::rand(state.range(0), state.range(0));
+    long axis = static_cast<long>(state.range(1));
+    pythonic::types::ndarray<double, 2> y = 0.999 + 0.002 * x;
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        pythonic::types::ndarray<double, 2> z = pythonic::numpy::cumprod(y, axis);
+        benchmark::DoNotOptimize(z.fbegin());
+    }
+}
+BENCHMARK(CumProd2D_Pythonic)->Apply(scan_args<2, RANGE_2D_MAX>);
+
+void Diff2D_Pythonic(benchmark::State& state)
+{
+    auto x = pythonic::numpy::random::rand(state.range(0), state.range(0));
+    long axis = static_cast<long>(state.range(1));
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        pythonic::types::ndarray<double, 2> z = pythonic::numpy::diff(x, 1, axis);
+        benchmark::DoNotOptimize(z.fbegin());
+    }
+}
+BENCHMARK(Diff2D_Pythonic)->Apply(scan_args<2, RANGE_2D_MAX>);
+#endif
+
+#undef RANGE_2D_MAX
+#undef RANGE_3D_MAX
+#undef SCAN_MIN
+#undef MULTIPLIER
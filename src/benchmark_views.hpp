@@ -9,6 +9,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include "cold_cache.hpp"
+
 #ifdef HAS_XTENSOR
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xio.hpp"
@@ -19,6 +21,7 @@
 #include "xtensor/xview.hpp"
 #include "xtensor/xdynamic_view.hpp"
 #include "xtensor/xadapt.hpp"
+#include "xtensor/xindex_view.hpp"
 #endif
 
 #ifdef HAS_EIGEN
@@ -51,6 +54,7 @@ void Add2dView_XTensor(benchmark::State& state)
 
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         xtensor<double,2> vRes(vAView + vBView);
         benchmark::DoNotOptimize(vRes.data());
     }
@@ -70,6 +74,7 @@ void Add2dView_Eigen(benchmark::State& state)
 
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         MatrixXd vRes(state.range(0), state.range(0));
         vRes.noalias() = vAView + vBView;
         benchmark::DoNotOptimize(vRes.data());
@@ -108,6 +113,7 @@ void Add2dStridedView_XTensor(benchmark::State& state)
 
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         xtensor<double, 2> vRes(vAView + vBView);
         benchmark::DoNotOptimize(vRes.data());
     }
@@ -126,6 +132,7 @@ void Add2dDynamicView_XTensor(benchmark::State& state)
 
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         xtensor<double, 2> vRes(vAView + vBView);
         benchmark::DoNotOptimize(vRes.data());
     }
@@ -145,6 +152,7 @@ void Add2dAdapt_XTensor(benchmark::State& state)
 
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         xtensor<double, 2> vRes(vAView + vBView);
         benchmark::DoNotOptimize(vRes.data());
     }
@@ -160,6 +168,7 @@ void Add2dLoop_XTensor(benchmark::State& state)
     std::array<std::size_t, 2> vShape = {static_cast<std::size_t>(state.range(0)), static_cast<std::size_t>(state.range(0))};
     for (auto _ : state)
     {
+        COLD_CACHE_SCOPE(state);
         xtensor<double, 2> vRes(vShape);
         for (std::size_t i = 0; i < vRes.shape()[0]; ++i)
         {
@@ -175,6 +184,373 @@ BENCHMARK(Add2dLoop_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
 #endif
 
 
+// Write-side views: the destination is a view on a larger tensor. Row
+// blocks are contiguous, column blocks and stepped ranges are strided.
+
+#ifdef HAS_XTENSOR
+void AssignRowsView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vX = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vY = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xt::view(vRes, range(lo, hi), all()) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignRowsView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void NoaliasAssignRowsView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vX = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vY = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(xt::view(vRes, range(lo, hi), all())) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(NoaliasAssignRowsView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void CompoundAssignRowsView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vZ = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(xt::view(vRes, range(lo, hi), all())) += vZ;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(CompoundAssignRowsView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignColsView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vX = random::rand<double>({n, hi - lo});
+    xtensor<double, 2> vY = random::rand<double>({n, hi - lo});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(xt::view(vRes, all(), range(lo, hi))) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignColsView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignStepView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vX = random::rand<double>({n, (n + 1) / 2});
+    xtensor<double, 2> vY = random::rand<double>({n, (n + 1) / 2});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(xt::view(vRes, all(), range(std::size_t(0), n, std::size_t(2)))) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignStepView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignRowsStridedView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vX = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vY = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(xt::strided_view(vRes, {range(lo, hi), all()})) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignRowsStridedView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignRowsDynamicView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    xtensor<double, 2> vX = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vY = random::rand<double>({hi - lo, n});
+    xtensor<double, 2> vRes = zeros<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(xt::dynamic_view(vRes, {range(lo, hi), all()})) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignRowsDynamicView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignIndexView1D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::size_t size = n * n;
+    std::vector<std::size_t> vIndices;
+    for (std::size_t i = 0; i < size; i += 2)
+    {
+        vIndices.push_back(i);
+    }
+    xtensor<double, 1> vX = random::rand<double>({vIndices.size()});
+    xtensor<double, 1> vY = random::rand<double>({vIndices.size()});
+    xtensor<double, 1> vRes = zeros<double>({size});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        noalias(index_view(vRes, vIndices)) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignIndexView1D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+// The source overlaps the destination shifted by one row: without noalias
+// xtensor has to evaluate into a temporary first.
+void AssignAliasingView2D_XTensor(benchmark::State& state)
+{
+    using namespace xt;
+
+    std::size_t n = static_cast<std::size_t>(state.range(0));
+    xtensor<double, 2> vX = random::rand<double>({n - 1, n});
+    xtensor<double, 2> vRes = random::rand<double>({n, n});
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        xt::view(vRes, range(std::size_t(1), n), all()) = xt::view(vRes, range(std::size_t(0), n - 1), all()) + vX;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignAliasingView2D_XTensor)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_EIGEN
+void AssignRowsView2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    using RowMatrixXd = Matrix<double, Dynamic, Dynamic, RowMajor>;
+
+    Index n = state.range(0);
+    Index lo = n / 4, rows = (n + 1) / 2;
+    RowMatrixXd vX = RowMatrixXd::Random(rows, n);
+    RowMatrixXd vY = RowMatrixXd::Random(rows, n);
+    RowMatrixXd vRes = RowMatrixXd::Zero(n, n);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.middleRows(lo, rows) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignRowsView2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void NoaliasAssignRowsView2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    using RowMatrixXd = Matrix<double, Dynamic, Dynamic, RowMajor>;
+
+    Index n = state.range(0);
+    Index lo = n / 4, rows = (n + 1) / 2;
+    RowMatrixXd vX = RowMatrixXd::Random(rows, n);
+    RowMatrixXd vY = RowMatrixXd::Random(rows, n);
+    RowMatrixXd vRes = RowMatrixXd::Zero(n, n);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.middleRows(lo, rows).noalias() = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(NoaliasAssignRowsView2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void CompoundAssignRowsView2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    using RowMatrixXd = Matrix<double, Dynamic, Dynamic, RowMajor>;
+
+    Index n = state.range(0);
+    Index lo = n / 4, rows = (n + 1) / 2;
+    RowMatrixXd vZ = RowMatrixXd::Random(rows, n);
+    RowMatrixXd vRes = RowMatrixXd::Zero(n, n);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.middleRows(lo, rows) += vZ;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(CompoundAssignRowsView2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignColsView2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    using RowMatrixXd = Matrix<double, Dynamic, Dynamic, RowMajor>;
+
+    Index n = state.range(0);
+    Index lo = n / 4, cols = (n + 1) / 2;
+    RowMatrixXd vX = RowMatrixXd::Random(n, cols);
+    RowMatrixXd vY = RowMatrixXd::Random(n, cols);
+    RowMatrixXd vRes = RowMatrixXd::Zero(n, n);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes.middleCols(lo, cols).noalias() = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignColsView2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignAliasingView2D_Eigen(benchmark::State& state)
+{
+    using namespace Eigen;
+    using RowMatrixXd = Matrix<double, Dynamic, Dynamic, RowMajor>;
+
+    Index n = state.range(0);
+    RowMatrixXd vX = RowMatrixXd::Random(n - 1, n);
+    RowMatrixXd vRes = RowMatrixXd::Random(n, n);
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        // Eigen does not detect the overlap, eval() makes the result correct
+        vRes.middleRows(1, n - 1) = (vRes.middleRows(0, n - 1) + vX).eval();
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignAliasingView2D_Eigen)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+#ifdef HAS_BLITZ
+void AssignRowsView2D_Blitz(benchmark::State& state)
+{
+    using namespace blitz;
+
+    int n = static_cast<int>(state.range(0));
+    int lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    Array<double, 2> vX(hi - lo, n);
+    Array<double, 2> vY(hi - lo, n);
+    Array<double, 2> vRes(n, n);
+    vX = 1.0;
+    vY = 2.0;
+    vRes = 0.0;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes(Range(lo, hi - 1), Range::all()) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignRowsView2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void CompoundAssignRowsView2D_Blitz(benchmark::State& state)
+{
+    using namespace blitz;
+
+    int n = static_cast<int>(state.range(0));
+    int lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    Array<double, 2> vZ(hi - lo, n);
+    Array<double, 2> vRes(n, n);
+    vZ = 1.0;
+    vRes = 0.0;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes(Range(lo, hi - 1), Range::all()) += vZ;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(CompoundAssignRowsView2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignColsView2D_Blitz(benchmark::State& state)
+{
+    using namespace blitz;
+
+    int n = static_cast<int>(state.range(0));
+    int lo = n / 4, hi = n / 4 + (n + 1) / 2;
+    Array<double, 2> vX(n, hi - lo);
+    Array<double, 2> vY(n, hi - lo);
+    Array<double, 2> vRes(n, n);
+    vX = 1.0;
+    vY = 2.0;
+    vRes = 0.0;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes(Range::all(), Range(lo, hi - 1)) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignColsView2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+
+void AssignStepView2D_Blitz(benchmark::State& state)
+{
+    using namespace blitz;
+
+    int n = static_cast<int>(state.range(0));
+    Array<double, 2> vX(n, (n + 1) / 2);
+    Array<double, 2> vY(n, (n + 1) / 2);
+    Array<double, 2> vRes(n, n);
+    vX = 1.0;
+    vY = 2.0;
+    vRes = 0.0;
+
+    for (auto _ : state)
+    {
+        COLD_CACHE_SCOPE(state);
+        vRes(Range::all(), Range(0, n - 1, 2)) = vX + vY;
+        benchmark::DoNotOptimize(vRes.data());
+    }
+}
+BENCHMARK(AssignStepView2D_Blitz)->RangeMultiplier(MULTIPLIER)->Range(RANGE);
+#endif
+
+
 #undef RANGE
 #undef MULTIPLIER
 
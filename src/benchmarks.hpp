@@ -0,0 +1,30 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+// All benchmark suites; included once by main.cpp, or once per instruction
+// set by isa_module.cpp when building with BENCHMARK_MULTI_ISA.
+
+#include "benchmark_add_1d.hpp"
+#include "benchmark_add_2d.hpp"
+#include "benchmark_views.hpp"
+#include "benchmark_broadcasting.hpp"
+#include "benchmark_fixed.hpp"
+#include "benchmark_constructor.hpp"
+#include "benchmark_scalar_assignment.hpp"
+#include "benchmark_iterators.hpp"
+#include "benchmark_layout.hpp"
+#include "benchmark_adapt.hpp"
+#include "benchmark_random.hpp"
+#include "benchmark_scan.hpp"
+
+// The I/O benchmarks do not depend on the instruction set: with
+// BENCHMARK_MULTI_ISA, main.cpp registers them once, in the executable.
+#ifndef XTENSOR_BENCHMARK_ISA
+#include "benchmark_io.hpp"
+#endif
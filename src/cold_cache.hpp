@@ -0,0 +1,209 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BENCHMARK_COLD_CACHE_HPP
+#define XTENSOR_BENCHMARK_COLD_CACHE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// Cold-cache mode, enabled with -DBENCHMARK_COLD_CACHE=ON.
+//
+// Kernels put COLD_CACHE_SCOPE(state) as the first statement of their loop.
+// In cold-cache mode, every iteration then starts by reading an eviction
+// buffer larger than the last level cache, so that the operands come from
+// memory as in a pipeline that touches every tensor once per stage. The
+// rest of the iteration is timed manually: PauseTiming/ResumeTiming read
+// the process CPU time, which costs more than the small kernels themselves.
+// Otherwise the macro expands to nothing.
+
+#ifndef COLD_CACHE_BYTES
+#define COLD_CACHE_BYTES 0
+#endif
+
+#ifndef COLD_CACHE_ITERATIONS
+#define COLD_CACHE_ITERATIONS 100
+#endif
+
+// Size of the largest cache of cpu0, or 0 if it cannot be found.
+inline std::size_t last_level_cache_size()
+{
+    std::size_t size = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+    long l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    size = l3 > 0 ? static_cast<std::size_t>(l3) : 0;
+#endif
+    for (int index = 0; size == 0 && index < 8; ++index)
+    {
+        std::ifstream in("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size");
+        std::string text;
+        if (!(in >> text) || text.empty())
+        {
+            continue;
+        }
+        std::size_t value = static_cast<std::size_t>(std::stoul(text));
+        char suffix = text.back();
+        value *= suffix == 'K' ? 1024 : suffix == 'M' ? 1024 * 1024 : 1;
+        size = std::max(size, value);
+    }
+    return size;
+}
+
+class cache_evictor
+{
+public:
+
+    static constexpr std::size_t line_size = 64;
+
+    cache_evictor()
+        : m_buffer(buffer_size(), 1)
+    {
+    }
+
+    // Reads one byte per cache line of the buffer. Reading rather than
+    // writing leaves no dirty lines behind to be written back while the
+    // next iteration is timed.
+    void evict()
+    {
+        unsigned char sum = 0;
+        for (std::size_t i = 0; i < m_buffer.size(); i += line_size)
+        {
+            sum = static_cast<unsigned char>(sum + m_buffer[i]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+
+private:
+
+    // Twice the last level cache, so that no operand survives in a
+    // non-inclusive hierarchy either; 64 MiB if the size is unknown.
+    static std::size_t buffer_size()
+    {
+        if (COLD_CACHE_BYTES > 0)
+        {
+            return static_cast<std::size_t>(COLD_CACHE_BYTES);
+        }
+        std::size_t llc = last_level_cache_size();
+        return llc > 0 ? 2 * llc : std::size_t(64) * 1024 * 1024;
+    }
+
+    std::vector<unsigned char> m_buffer;
+};
+
+inline void cold_cache_evict()
+{
+    static cache_evictor evictor;
+    evictor.evict();
+}
+
+// Found by unqualified lookup only when google benchmark predates
+// AddCustomContext (v1.5.3); the real function is a better match.
+namespace cold_cache_fallback
+{
+    inline void AddCustomContext(...)
+    {
+    }
+}
+
+// Tags the JSON context with cache=cold in cold-cache mode, when google
+// benchmark supports it. report.py recognizes cold runs by their
+// /manual_time suffix anyway.
+inline void cold_cache_add_context()
+{
+#ifdef COLD_CACHE_MODE
+    using namespace benchmark;
+    using namespace cold_cache_fallback;
+    AddCustomContext("cache", "cold");
+#endif
+}
+
+// Every registration goes through this hook. In cold-cache mode, it makes
+// google benchmark report the manual time; and since the iteration count
+// would be derived from the timed part only, making the small kernels pay
+// for millions of evictions, it fixes it to COLD_CACHE_ITERATIONS.
+inline benchmark::internal::Benchmark* cold_cache_register(benchmark::internal::Benchmark* b)
+{
+#ifdef COLD_CACHE_MODE
+    b->UseManualTime()->Iterations(COLD_CACHE_ITERATIONS);
+#endif
+    return b;
+}
+
+// Replaces UseRealTime() in multi-threaded registrations: google benchmark
+// rejects it on top of the manual time set by cold_cache_register, which is
+// wall-clock time already.
+inline void use_real_time(benchmark::internal::Benchmark* b)
+{
+#ifdef COLD_CACHE_MODE
+    (void)b;
+#else
+    b->UseRealTime();
+#endif
+}
+
+// isa_benchmark.hpp calls the hook from its own registration macros.
+#if defined(COLD_CACHE_MODE) && !defined(XTENSOR_BENCHMARK_ISA)
+#define COLD_CACHE_CONCAT_IMPL(a, b) a##b
+#define COLD_CACHE_CONCAT(a, b) COLD_CACHE_CONCAT_IMPL(a, b)
+#define COLD_CACHE_DECLARE \
+    static ::benchmark::internal::Benchmark* COLD_CACHE_CONCAT(cold_cache_benchmark_, __COUNTER__) BENCHMARK_UNUSED
+
+#undef BENCHMARK
+#define BENCHMARK(n) \
+    COLD_CACHE_DECLARE = cold_cache_register(::benchmark::RegisterBenchmark(#n, n))
+
+#undef BENCHMARK_TEMPLATE
+#define BENCHMARK_TEMPLATE(n, ...) \
+    COLD_CACHE_DECLARE = cold_cache_register(::benchmark::RegisterBenchmark(#n "<" #__VA_ARGS__ ">", n<__VA_ARGS__>))
+#endif
+
+// Evicts the caches, then times the rest of the iteration (including the
+// destruction of its temporaries) as its manual time.
+class cold_cache_timer
+{
+public:
+
+    using clock_type = std::chrono::steady_clock;
+
+    explicit cold_cache_timer(benchmark::State& state)
+        : m_state(state)
+    {
+        cold_cache_evict();
+        m_start = clock_type::now();
+    }
+
+    ~cold_cache_timer()
+    {
+        std::chrono::duration<double> elapsed = clock_type::now() - m_start;
+        m_state.SetIterationTime(elapsed.count());
+    }
+
+private:
+
+    benchmark::State& m_state;
+    clock_type::time_point m_start;
+};
+
+#ifdef COLD_CACHE_MODE
+#define COLD_CACHE_SCOPE(state) cold_cache_timer cold_cache_timer_instance(state)
+#else
+#define COLD_CACHE_SCOPE(state)
+#endif
+
+#endif
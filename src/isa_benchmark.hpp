@@ -0,0 +1,38 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BENCHMARK_ISA_BENCHMARK_HPP
+#define XTENSOR_BENCHMARK_ISA_BENCHMARK_HPP
+
+#include <benchmark/benchmark.h>
+
+#include "cold_cache.hpp"
+
+// Registers every benchmark of an instruction set module under the name
+// <name>@<isa>, e.g. Add2D_XTensor@avx2/64, so that the same kernel built
+// for several instruction sets can run side by side.
+
+#ifndef XTENSOR_BENCHMARK_ISA
+#error "XTENSOR_BENCHMARK_ISA must be defined to the name of the instruction set"
+#endif
+
+#define XTENSOR_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define XTENSOR_BENCHMARK_CONCAT(a, b) XTENSOR_BENCHMARK_CONCAT_IMPL(a, b)
+#define XTENSOR_BENCHMARK_DECLARE \
+    static ::benchmark::internal::Benchmark* XTENSOR_BENCHMARK_CONCAT(isa_benchmark_, __COUNTER__) BENCHMARK_UNUSED
+
+#undef BENCHMARK
+#define BENCHMARK(n) \
+    XTENSOR_BENCHMARK_DECLARE = cold_cache_register(::benchmark::RegisterBenchmark(#n "@" XTENSOR_BENCHMARK_ISA, n))
+
+#undef BENCHMARK_TEMPLATE
+#define BENCHMARK_TEMPLATE(n, ...) \
+    XTENSOR_BENCHMARK_DECLARE = cold_cache_register(::benchmark::RegisterBenchmark(#n "<" #__VA_ARGS__ ">@" XTENSOR_BENCHMARK_ISA, n<__VA_ARGS__>))
+
+#endif
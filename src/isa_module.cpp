@@ -0,0 +1,27 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+// One instruction set module of a BENCHMARK_MULTI_ISA build. It is compiled
+// once per instruction set with hidden visibility and loaded with dlopen by
+// main.cpp, so that the template instantiations of each module stay
+// separate; its benchmarks register themselves when the module is loaded.
+
+#include <iostream>
+
+#include "isa_benchmark.hpp"
+#include "benchmarks.hpp"
+
+extern "C" __attribute__((visibility("default"))) void xtensor_benchmark_print_stats()
+{
+#if defined(HAS_XTENSOR) && defined(XTENSOR_USE_XSIMD)
+    std::cout << XTENSOR_BENCHMARK_ISA << ": USING XSIMD, SIMD SIZE: " << xsimd::simd_traits<double>::size << "\n";
+#else
+    std::cout << XTENSOR_BENCHMARK_ISA << ": NOT USING XSIMD\n";
+#endif
+}
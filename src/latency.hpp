@@ -0,0 +1,162 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BENCHMARK_LATENCY_HPP
+#define XTENSOR_BENCHMARK_LATENCY_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Latency distribution mode, enabled with -DBENCHMARK_LATENCY=ON.
+//
+// Kernels put LATENCY_HISTOGRAM(state) before their loop and LATENCY_SCOPE
+// as the first statement of the loop body. In latency mode every iteration
+// is then timed (including the destruction of its temporaries) and the
+// p50/p90/p99/p99.9/max latencies are reported as counters, in ns. Timing
+// each iteration adds the clock overhead to the mean, so the mode is off
+// by default and the macros expand to nothing. With several threads, the
+// counters are the average of the per-thread percentiles.
+
+class latency_histogram
+{
+public:
+
+    using clock_type = std::chrono::steady_clock;
+
+    explicit latency_histogram(benchmark::State& state)
+        : m_state(state), m_buckets(bucket_count, 0), m_count(0), m_max(0), m_overhead(clock_overhead())
+    {
+    }
+
+    ~latency_histogram()
+    {
+        if (m_count == 0)
+        {
+            return;
+        }
+        m_state.counters["p50_ns"] = benchmark::Counter(static_cast<double>(percentile(0.5)), benchmark::Counter::kAvgThreads);
+        m_state.counters["p90_ns"] = benchmark::Counter(static_cast<double>(percentile(0.9)), benchmark::Counter::kAvgThreads);
+        m_state.counters["p99_ns"] = benchmark::Counter(static_cast<double>(percentile(0.99)), benchmark::Counter::kAvgThreads);
+        m_state.counters["p99.9_ns"] = benchmark::Counter(static_cast<double>(percentile(0.999)), benchmark::Counter::kAvgThreads);
+        m_state.counters["max_ns"] = benchmark::Counter(static_cast<double>(m_max), benchmark::Counter::kAvgThreads);
+    }
+
+    void record(clock_type::duration elapsed)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        std::uint64_t value = ns > m_overhead ? static_cast<std::uint64_t>(ns - m_overhead) : 0;
+        ++m_buckets[bucket_index(value)];
+        ++m_count;
+        m_max = std::max(m_max, value);
+    }
+
+private:
+
+    // Log-linear buckets: exact below 2^sub_bits ns, then 2^sub_bits
+    // buckets per power of two, i.e. a relative error under 1/64.
+    static constexpr int sub_bits = 6;
+    static constexpr std::size_t sub_count = std::size_t(1) << sub_bits;
+    static constexpr std::size_t bucket_count = (64 - sub_bits + 1) * sub_count;
+
+    static std::size_t bucket_index(std::uint64_t value)
+    {
+        if (value < sub_count)
+        {
+            return static_cast<std::size_t>(value);
+        }
+        int exponent = sub_bits;
+        while ((value >> (exponent + 1)) != 0)
+        {
+            ++exponent;
+        }
+        std::size_t mantissa = static_cast<std::size_t>(value >> (exponent - sub_bits)) & (sub_count - 1);
+        return static_cast<std::size_t>(exponent - sub_bits + 1) * sub_count + mantissa;
+    }
+
+    static std::uint64_t bucket_value(std::size_t index)
+    {
+        if (index < sub_count)
+        {
+            return index;
+        }
+        int exponent = static_cast<int>(index / sub_count) + sub_bits - 1;
+        std::uint64_t mantissa = index % sub_count;
+        return (sub_count + mantissa) << (exponent - sub_bits);
+    }
+
+    // Smallest of a few back-to-back clock reads, subtracted from every
+    // sample so that tiny kernels are not dominated by the clock itself.
+    static std::int64_t clock_overhead()
+    {
+        auto best = clock_type::duration::max();
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto start = clock_type::now();
+            auto stop = clock_type::now();
+            best = std::min(best, stop - start);
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(best).count();
+    }
+
+    std::uint64_t percentile(double p) const
+    {
+        std::uint64_t rank = static_cast<std::uint64_t>(p * static_cast<double>(m_count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < m_buckets.size(); ++i)
+        {
+            seen += m_buckets[i];
+            if (seen >= rank)
+            {
+                return std::min(bucket_value(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    benchmark::State& m_state;
+    std::vector<std::uint64_t> m_buckets;
+    std::uint64_t m_count;
+    std::uint64_t m_max;
+    std::int64_t m_overhead;
+};
+
+class latency_timer
+{
+public:
+
+    explicit latency_timer(latency_histogram& histogram)
+        : m_histogram(histogram), m_start(latency_histogram::clock_type::now())
+    {
+    }
+
+    ~latency_timer()
+    {
+        m_histogram.record(latency_histogram::clock_type::now() - m_start);
+    }
+
+private:
+
+    latency_histogram& m_histogram;
+    latency_histogram::clock_type::time_point m_start;
+};
+
+#ifdef LATENCY_HISTOGRAM_MODE
+#define LATENCY_HISTOGRAM(state) latency_histogram latency_histogram_instance(state)
+#define LATENCY_SCOPE latency_timer latency_timer_instance(latency_histogram_instance)
+#else
+#define LATENCY_HISTOGRAM(state)
+#define LATENCY_SCOPE
+#endif
+
+#endif
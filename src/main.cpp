@@ -11,15 +11,141 @@
 
 #include <benchmark/benchmark.h>
 
-#include "benchmark_add_1d.hpp"
-#include "benchmark_add_2d.hpp"
-#include "benchmark_views.hpp"
-#include "benchmark_broadcasting.hpp"
-#include "benchmark_fixed.hpp"
-#include "benchmark_constructor.hpp"
-#include "benchmark_scalar_assignment.hpp"
-#include "benchmark_iterators.hpp"
+#ifdef XTENSOR_BENCHMARK_MULTI_ISA
 
+#include <cstring>
+#include <string>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+// The allocation counter must live in the executable: interposing malloc
+// from a module loaded with RTLD_LOCAL would not see most allocations.
+#include "allocation_counter.hpp"
+#include "cold_cache.hpp"
+
+// Registered once rather than per instruction set, see benchmarks.hpp.
+#include "benchmark_io.hpp"
+
+const char* const isa_names[] = {"scalar", "sse4_2", "avx2", "avx512"};
+
+bool isa_supported(const std::string& isa)
+{
+    __builtin_cpu_init();
+    if (isa == "scalar")
+    {
+        return true;
+    }
+    if (isa == "sse4_2")
+    {
+        return __builtin_cpu_supports("sse4.2");
+    }
+    if (isa == "avx2")
+    {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+    if (isa == "avx512")
+    {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") &&
+               __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("avx512vl");
+    }
+    return false;
+}
+
+std::string executable_directory(const char* argv0)
+{
+    char buffer[4096];
+    ssize_t length = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
+    std::string path = length > 0 ? std::string(buffer, static_cast<std::size_t>(length)) : std::string(argv0);
+    std::size_t pos = path.rfind('/');
+    return pos == std::string::npos ? std::string(".") : path.substr(0, pos);
+}
+
+// Removes --isa=<comma separated list> from the arguments, google benchmark
+// would reject it. Without it, every instruction set the CPU supports is run.
+std::string extract_isa_selection(int& argc, char** argv)
+{
+    const char* flag = "--isa=";
+    std::string selection;
+    int out = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0)
+        {
+            selection = argv[i] + std::strlen(flag);
+        }
+        else
+        {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+    return selection;
+}
+
+bool isa_selected(const std::string& selection, const std::string& isa)
+{
+    if (selection.empty())
+    {
+        return true;
+    }
+    std::string list = "," + selection + ",";
+    return list.find("," + isa + ",") != std::string::npos;
+}
+
+int load_isa_modules(const std::string& directory, const std::string& selection)
+{
+    int loaded = 0;
+    for (const char* isa : isa_names)
+    {
+        if (!isa_selected(selection, isa))
+        {
+            continue;
+        }
+        if (!isa_supported(isa))
+        {
+            std::cout << isa << ": NOT SUPPORTED BY THIS CPU\n";
+            continue;
+        }
+        std::string path = directory + "/xtensor_benchmark_" + isa + ".so";
+        void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (handle == nullptr)
+        {
+            std::cerr << isa << ": " << dlerror() << "\n";
+            continue;
+        }
+        using print_stats_type = void (*)();
+        auto print_stats = reinterpret_cast<print_stats_type>(dlsym(handle, "xtensor_benchmark_print_stats"));
+        if (print_stats != nullptr)
+        {
+            print_stats();
+        }
+        ++loaded;
+    }
+    std::cout << "\n";
+    return loaded;
+}
+
+// Custom main function to load the instruction set modules and print
+// their SIMD config
+int main(int argc, char** argv)
+{
+    std::string selection = extract_isa_selection(argc, argv);
+    cold_cache_add_context();
+    if (load_isa_modules(executable_directory(argv[0]), selection) == 0)
+    {
+        std::cerr << "no instruction set module could be loaded\n";
+        return 1;
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+}
+
+#else
+
+#include "benchmarks.hpp"
 
 #ifdef XTENSOR_USE_XSIMD
 #ifdef __GNUC__
@@ -48,7 +174,10 @@ void print_stats()
 int main(int argc, char** argv)
 {
     print_stats();
+    cold_cache_add_context();
     benchmark::Initialize(&argc, argv);
     if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
     benchmark::RunSpecifiedBenchmarks();
 }
+
+#endif
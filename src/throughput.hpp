@@ -0,0 +1,64 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay and Wolf Vollprecht          *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_BENCHMARK_THROUGHPUT_HPP
+#define XTENSOR_BENCHMARK_THROUGHPUT_HPP
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "cold_cache.hpp"
+
+// Multi-tenant throughput mode, enabled with -DBENCHMARK_THROUGHPUT=ON.
+//
+// Kernels registered with ->Apply(throughput_threads) additionally run on
+// 1, 2, 4, ... threads up to THROUGHPUT_MAX_THREADS (default: the number
+// of hardware threads). Every thread runs the kernel function, and so owns
+// its operands; the time per iteration is measured in real time, so that
+// report.py can derive the aggregate operations per second and the
+// per-thread slowdown compared with a single thread.
+//
+// The default random engine of xtensor (and pythran) is shared by all the
+// threads: kernels that draw their operands from it do so between
+// THROUGHPUT_SETUP_BEGIN and THROUGHPUT_SETUP_END, which serialize the
+// setup in throughput mode and expand to nothing otherwise.
+
+#ifndef THROUGHPUT_MAX_THREADS
+#define THROUGHPUT_MAX_THREADS 0
+#endif
+
+inline void throughput_threads(benchmark::internal::Benchmark* b)
+{
+#ifdef THROUGHPUT_MODE
+    int max_threads = THROUGHPUT_MAX_THREADS > 0 ? THROUGHPUT_MAX_THREADS
+                                                 : static_cast<int>(std::thread::hardware_concurrency());
+    b->ThreadRange(1, std::max(1, max_threads))->Apply(use_real_time);
+#else
+    (void)b;
+#endif
+}
+
+inline std::mutex& throughput_setup_mutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+#ifdef THROUGHPUT_MODE
+#define THROUGHPUT_SETUP_BEGIN std::unique_lock<std::mutex> throughput_setup_lock(throughput_setup_mutex())
+#define THROUGHPUT_SETUP_END throughput_setup_lock.unlock()
+#else
+#define THROUGHPUT_SETUP_BEGIN
+#define THROUGHPUT_SETUP_END
+#endif
+
+#endif